@@ -12,6 +12,7 @@
 #include <XivAlexanderCommon/Sqex/Sound/Reader.h>
 #include <XivAlexanderCommon/Sqex/Sound/Writer.h>
 #include <XivAlexanderCommon/Sqex/Sqpack/BinaryEntryProvider.h>
+#include <XivAlexanderCommon/Sqex/Sqpack/BuildCache.h>
 #include <XivAlexanderCommon/Sqex/Sqpack/Creator.h>
 #include <XivAlexanderCommon/Sqex/Sqpack/EntryProvider.h>
 #include <XivAlexanderCommon/Sqex/Sqpack/EntryRawStream.h>
@@ -458,6 +459,7 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 			throw std::runtime_error("Cancelled");
 
 		{
+			auto buildCache = Sqex::Sqpack::BuildCache(Config->Init.ResolveConfigStorageDirectoryPath() / "SqpackBuildCache.json");
 			std::mutex groupedLogPrintLock;
 			const auto progressMax = creators.size() * (0
 				+ 1 // original sqpack
@@ -554,7 +556,8 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 									return NestedTtmp::Continue;
 								const auto& ttmp = *nestedTtmp.Ttmp;
 
-								creator.ReserveSpacesFromTTMP(ttmp.List, std::make_shared<Sqex::FileRandomAccessStream>(Utils::Win32::Handle(ttmp.DataFile, false)));
+								creator.ReserveSpacesFromTTMP(ttmp.List, std::make_shared<Sqex::FileRandomAccessStream>(Utils::Win32::Handle(ttmp.DataFile, false)),
+									buildCache, ttmp.ListPath, ttmp.ListPath.parent_path() / "TTMPD.mpd");
 								return NestedTtmp::Continue;
 								}) == NestedTtmp::Break)
 								return;
@@ -577,6 +580,14 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 			} while (WAIT_TIMEOUT == progressWindow.DoModalLoop(100, { loaderThread }));
 			pool.Cancel();
 			loaderThread.Wait();
+
+			if (progressWindow.GetCancelEvent().Wait(0) != WAIT_OBJECT_0) {
+				try {
+					buildCache.Save();
+				} catch (const std::exception& e) {
+					Logger->Format<LogLevel::Warning>(LogCategory::VirtualSqPacks, "Failed to save build cache: {}", e.what());
+				}
+			}
 		}
 
 		if (progressWindow.GetCancelEvent().Wait(0) == WAIT_OBJECT_0)
@@ -607,6 +618,7 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 						throw std::runtime_error("Cancelled");
 
 					pool.SubmitWork([&]() {
+						// No deduplication here; entries sharing an allocation could not be swapped by TTMPs applied later.
 						auto v = pCreator->AsViews(false, pCreator->DatName.starts_with("0c") ? nullptr : dataViewBuffer);
 
 						//if (pCreator->DatName.starts_with("0a")) {
@@ -977,6 +989,7 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 					readers.emplace_back(std::make_unique<Sqex::Sqpack::Reader>(file));
 				}
 
+				std::vector<std::string> configFileHashes;
 				for (const auto& configFile : excelTransformConfigFiles) {
 					uint8_t hash[20]{};
 					try {
@@ -996,6 +1009,7 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 					encoder.Get(reinterpret_cast<byte*>(&buf[0]), buf.size());
 
 					currentCacheKeys += std::format("CONF:{}:{}\n", configFile.wstring(), buf);
+					configFileHashes.emplace_back(std::move(buf));
 				}
 
 				auto needRecreate = true;
@@ -1013,19 +1027,40 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 					std::vector<std::pair<srell::u8cregex, std::map<Sqex::Language, std::vector<size_t>>>> columnMaps;
 					std::vector<std::pair<srell::u8cregex, Misc::ExcelTransformConfig::PluralColumns>> pluralColumns;
 					struct ReplacementRule {
-						srell::u8cregex exhNamePattern;
-						srell::u8cregex stringPattern;
+						std::shared_ptr<const Misc::ExcelTransformConfig::StringPattern> stringPattern;
 						std::vector<Sqex::Language> sourceLanguage;
 						std::string replaceTo;
-						std::set<size_t> columnIndices;
 						std::map<Sqex::Language, std::vector<std::string>> preprocessReplacements;
 						std::vector<std::string> postprocessReplacements;
 					};
-					std::map<Sqex::Language, std::vector<ReplacementRule>> rowReplacementRules;
+					struct ReplacementRuleTarget {
+						std::shared_ptr<const srell::u8cregex> exhNamePattern;
+						std::vector<size_t> columnIndices;
+						std::shared_ptr<const ReplacementRule> rule;
+					};
+					Misc::ExcelTransformConfig::PatternCache patternCache;
+					std::map<Sqex::Language, std::vector<ReplacementRuleTarget>> rowReplacementRules;
 					std::map<Sqex::Language, std::set<Misc::ExcelTransformConfig::IgnoredCell>> ignoredCells;
 					std::map<std::string, std::pair<srell::u8cregex, std::string>> columnReplacementTemplates;
+					std::map<std::string, std::string> columnReplacementTemplateSources;  // template name to ConfigDependency::Key of the file defining it
+
+					// Which sheets a config file can affect, so that editing it only invalidates those sheets.
+					struct ConfigDependency {
+						std::string Key;
+						std::vector<std::shared_ptr<const srell::u8cregex>> ExhNamePatterns;
+						std::vector<std::string> IgnoredCellExhNames;
+						std::set<std::string> ReplacementTemplateNames;  // may be defined in another file
+
+						[[nodiscard]] bool Affects(const std::string& exhName) const {
+							return std::ranges::any_of(ExhNamePatterns, [&](const auto& pattern) { return srell::regex_search(exhName, *pattern); })
+								|| std::ranges::any_of(IgnoredCellExhNames, [&](const auto& name) { return 0 == _stricmp(name.c_str(), exhName.c_str()); });
+						}
+					};
+					std::vector<ConfigDependency> configDependencies;
+
 					auto replacementFileParseFail = false;
-					for (const auto& configFile : Config->Runtime.ExcelTransformConfigFiles.Value()) {
+					for (size_t configFileIndex = 0; configFileIndex < excelTransformConfigFiles.size(); ++configFileIndex) {
+						const auto& configFile = excelTransformConfigFiles[configFileIndex];
 						if (configFile.empty())
 							continue;
 
@@ -1033,29 +1068,46 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 							Misc::ExcelTransformConfig::Config transformConfig;
 							from_json(Utils::ParseJsonFromFile(Config->TranslatePath(configFile)), transformConfig);
 
+							auto& dependency = configDependencies.emplace_back(ConfigDependency{
+								.Key = std::format("{}:{}", Utils::ToUtf8(configFile.wstring()), configFileHashes[configFileIndex]),
+							});
 							for (const auto& entry : transformConfig.columnMap) {
 								columnMaps.emplace_back(srell::u8cregex(entry.first, srell::regex_constants::ECMAScript | srell::regex_constants::icase), entry.second);
+								dependency.ExhNamePatterns.emplace_back(patternCache.GetRegex(entry.first, true));
 							}
 							for (const auto& entry : transformConfig.pluralMap) {
 								pluralColumns.emplace_back(srell::u8cregex(entry.first, srell::regex_constants::ECMAScript | srell::regex_constants::icase), entry.second);
+								dependency.ExhNamePatterns.emplace_back(patternCache.GetRegex(entry.first, true));
 							}
 							for (const auto& entry : transformConfig.replacementTemplates) {
-								columnReplacementTemplates.emplace(entry.first, std::make_pair(
+								const auto [_, inserted] = columnReplacementTemplates.emplace(entry.first, std::make_pair(
 									srell::u8cregex(entry.second.from, srell::regex_constants::ECMAScript | (entry.second.icase ? srell::regex_constants::icase : srell::regex_constants::syntax_option_type())),
 									entry.second.to));
+								if (inserted)
+									columnReplacementTemplateSources.emplace(entry.first, dependency.Key);
 							}
 							ignoredCells[transformConfig.targetLanguage].insert(transformConfig.ignoredCells.begin(), transformConfig.ignoredCells.end());
+							for (const auto& cell : transformConfig.ignoredCells)
+								dependency.IgnoredCellExhNames.emplace_back(cell.name);
 							for (const auto& rule : transformConfig.rules) {
+								const auto compiledRule = std::make_shared<const ReplacementRule>(ReplacementRule{
+									patternCache.GetStringPattern(rule.stringPattern, true),
+									transformConfig.sourceLanguages,
+									rule.replaceTo,
+									rule.preprocessReplacements,
+									rule.postprocessReplacements,
+									});
+								for (const auto& names : rule.preprocessReplacements | std::views::values)
+									dependency.ReplacementTemplateNames.insert(names.begin(), names.end());
+								dependency.ReplacementTemplateNames.insert(rule.postprocessReplacements.begin(), rule.postprocessReplacements.end());
 								for (const auto& targetGroupName : rule.targetGroups) {
 									for (const auto& target : transformConfig.targetGroups.at(targetGroupName).columnIndices) {
-										rowReplacementRules[transformConfig.targetLanguage].emplace_back(ReplacementRule{
-											srell::u8cregex(target.first, srell::regex_constants::ECMAScript | srell::regex_constants::icase),
-											srell::u8cregex(rule.stringPattern, srell::regex_constants::ECMAScript | srell::regex_constants::icase),
-											transformConfig.sourceLanguages,
-											rule.replaceTo,
-											{target.second.begin(), target.second.end()},
-											rule.preprocessReplacements,
-											rule.postprocessReplacements,
+										auto exhNamePattern = patternCache.GetRegex(target.first, true);
+										dependency.ExhNamePatterns.emplace_back(exhNamePattern);
+										rowReplacementRules[transformConfig.targetLanguage].emplace_back(ReplacementRuleTarget{
+											std::move(exhNamePattern),
+											target.second,
+											compiledRule,
 											});
 									}
 								}
@@ -1082,12 +1134,151 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 					for (const auto& exhName : exhTable | std::views::keys)
 						progressPerTask.emplace(exhName, 0);
 					progressWindow.UpdateProgress(0, 1ULL * exhTable.size() * ProgressMaxPerTask);
+
+					// Every generated sheet remembers the hash of everything it was generated from, and which entries it produced.
+					// Sheets whose hash did not change get their entries copied over from the previous output instead of being generated again.
+					struct SheetCacheRecord {
+						std::string Key;
+						std::vector<std::string> Entries;
+					};
+					std::map<std::string, SheetCacheRecord> sheetCacheRecords;
+					std::atomic_size_t sheetCacheHits = 0, sheetCacheMisses = 0;
 					{
 						const auto ttmpl = Utils::Win32::Handle::FromCreateFile(cachedDir / "TTMPL.mpl.tmp", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, 0);
 						const auto ttmpd = Utils::Win32::Handle::FromCreateFile(cachedDir / "TTMPD.mpd.tmp", GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, 0);
 						uint64_t ttmplPtr = 0, ttmpdPtr = 0;
 						std::mutex writeMtx;
 
+						const auto writeEntry = [&](std::string fullPath, std::span<const char> data) {
+							const auto lock = std::lock_guard(writeMtx);
+							const auto entryLine = std::format("{}\n", nlohmann::json::object({
+								{"FullPath", std::move(fullPath)},
+								{"ModOffset", ttmpdPtr},
+								{"ModSize", data.size()},
+								{"DatFile", "0a0000"},
+								}).dump());
+							ttmplPtr += ttmpl.Write(ttmplPtr, std::span(entryLine));
+							ttmpdPtr += ttmpd.Write(ttmpdPtr, data);
+						};
+
+						std::map<std::string, SheetCacheRecord> previousSheetCacheRecords;
+						std::map<std::string, std::pair<uint64_t, size_t>> previousEntries;
+						Utils::Win32::Handle previousTtmpd;
+						try {
+							previousTtmpd = Utils::Win32::Handle::FromCreateFile(cachedDir / "TTMPD.mpd", GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0);
+
+							const auto previousTtmpl = Utils::Win32::Handle::FromCreateFile(cachedDir / "TTMPL.mpl", GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0);
+							const auto previousTtmplContent = previousTtmpl.Read<char>(0, static_cast<size_t>(previousTtmpl.GetFileSize()));
+							for (auto remaining = std::string_view(previousTtmplContent.data(), previousTtmplContent.size()); !remaining.empty();) {
+								const auto line = remaining.substr(0, remaining.find('\n'));
+								remaining = remaining.substr(std::min(remaining.size(), line.size() + 1));
+								if (line.empty())
+									continue;
+
+								const auto entry = nlohmann::json::parse(line);
+								previousEntries.insert_or_assign(
+									entry.at("FullPath").get<std::string>(),
+									std::make_pair(entry.at("ModOffset").get<uint64_t>(), entry.at("ModSize").get<size_t>()));
+							}
+
+							for (const auto& [exhName, record] : Utils::ParseJsonFromFile(cachedDir / "sheets.json", 256 * 1048576).at("sheets").items()) {
+								previousSheetCacheRecords.emplace(exhName, SheetCacheRecord{
+									.Key = record.at("key").get<std::string>(),
+									.Entries = record.at("entries").get<std::vector<std::string>>(),
+								});
+							}
+						} catch (...) {
+							// no usable previous output; generate everything
+							previousSheetCacheRecords.clear();
+							previousEntries.clear();
+						}
+
+						// Returns an empty string if the inputs could not be read; such sheets are always generated again.
+						const auto calculateSheetCacheKey = [&](const std::string& exhName) -> std::string {
+							CryptoPP::SHA1 sha1;
+							const auto updateString = [&sha1](const std::string& s) {
+								const auto size = static_cast<uint64_t>(s.size());
+								sha1.Update(reinterpret_cast<const byte*>(&size), sizeof size);
+								sha1.Update(reinterpret_cast<const byte*>(s.data()), s.size());
+							};
+							const auto updateEntry = [&sha1](const auto& source, const Sqex::Sqpack::EntryPathSpec& pathSpec) -> std::shared_ptr<Sqex::RandomAccessStream> {
+								std::shared_ptr<Sqex::RandomAccessStream> stream;
+								try {
+									stream = source[pathSpec];
+								} catch (const std::out_of_range&) {
+									constexpr uint64_t missing = UINT64_MAX;
+									sha1.Update(reinterpret_cast<const byte*>(&missing), sizeof missing);
+									return nullptr;
+								}
+								const auto data = stream->ReadStreamIntoVector<uint8_t>(0);
+								const auto size = static_cast<uint64_t>(data.size());
+								sha1.Update(reinterpret_cast<const byte*>(&size), sizeof size);
+								sha1.Update(data.data(), data.size());
+								return stream;
+							};
+							const auto updateSheet = [&](const auto& source) {
+								const auto exhStream = updateEntry(source, Sqex::Sqpack::EntryPathSpec(std::format("exd/{}.exh", exhName)));
+								if (!exhStream)
+									return;
+
+								const auto exhReader = Sqex::Excel::ExhReader(exhName, *exhStream);
+								for (const auto language : exhReader.Languages) {
+									for (const auto& page : exhReader.Pages)
+										updateEntry(source, exhReader.GetDataPathSpec(page, language));
+								}
+							};
+
+							try {
+								updateString(std::format("compress:{}", Config->Runtime.CompressModdedFiles ? "true" : "false"));
+								for (const auto& lang : fallbackLanguageList)
+									updateString(std::format("lang:{}", static_cast<int>(lang)));
+								updateString(exhName);
+								for (const auto& dependency : configDependencies) {
+									if (!dependency.Affects(exhName))
+										continue;
+
+									updateString(dependency.Key);
+									for (const auto& templateName : dependency.ReplacementTemplateNames) {
+										if (const auto it = columnReplacementTemplateSources.find(templateName); it != columnReplacementTemplateSources.end())
+											updateString(std::format("template:{}:{}", templateName, it->second));
+									}
+								}
+
+								updateSheet(creator);
+								for (const auto& reader : readers)
+									updateSheet(*reader);
+							} catch (const std::exception&) {
+								return {};
+							}
+
+							uint8_t hash[CryptoPP::SHA1::DIGESTSIZE]{};
+							sha1.Final(hash);
+
+							CryptoPP::HexEncoder encoder;
+							encoder.Put(hash, sizeof hash);
+							encoder.MessageEnd();
+
+							std::string buf(static_cast<size_t>(encoder.MaxRetrievable()), 0);
+							encoder.Get(reinterpret_cast<byte*>(&buf[0]), buf.size());
+							return buf;
+						};
+
+						// Returns false if any of the entries produced last time has gone missing from the previous output.
+						const auto copyPreviousSheetOutput = [&](const SheetCacheRecord& record) {
+							std::vector<std::vector<char>> data;
+							for (const auto& entryPath : record.Entries) {
+								const auto it = previousEntries.find(entryPath);
+								if (it == previousEntries.end())
+									return false;
+								data.emplace_back(previousTtmpd.Read<char>(it->second.first, it->second.second));
+								if (data.back().size() != it->second.second)
+									return false;
+							}
+							for (size_t i = 0; i < data.size(); ++i)
+								writeEntry(record.Entries[i], std::span(data[i]));
+							return true;
+						};
+
 						std::string errorMessage;
 						const auto compressThread = Utils::Win32::Thread(L"CompressThread", [&]() {
 							for (const auto& exhName : exhTable | std::views::keys) {
@@ -1106,6 +1297,26 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 											progressStoreTarget = (1ULL * progressIndex * ProgressMaxPerTask + (currentProgressMax ? currentProgress * ProgressMaxPerTask / currentProgressMax : 0)) / (readers.size() + 2ULL);
 										};
 
+										lastStep = "Look up previous output";
+										SheetCacheRecord sheetCacheRecord{ .Key = calculateSheetCacheKey(exhName) };
+										const auto storeSheetCacheRecord = [&]() {
+											const auto lock = std::lock_guard(writeMtx);
+											sheetCacheRecords.insert_or_assign(exhName, std::move(sheetCacheRecord));
+										};
+										if (const auto it = previousSheetCacheRecords.find(exhName);
+											!sheetCacheRecord.Key.empty() && it != previousSheetCacheRecords.end() && it->second.Key == sheetCacheRecord.Key
+											&& copyPreviousSheetOutput(it->second)) {
+											Logger->Format<LogLevel::Debug>(LogCategory::VirtualSqPacks, "[{}] Reusing previous output", exhName);
+											sheetCacheRecord.Entries = it->second.Entries;
+											storeSheetCacheRecord();
+											++sheetCacheHits;
+											progressStoreTarget = ProgressMaxPerTask;
+											return;
+										}
+										Logger->Format<LogLevel::Debug>(LogCategory::VirtualSqPacks, "[{}] Generating: {}", exhName,
+											previousSheetCacheRecords.contains(exhName) ? "inputs have changed" : "not in previous output");
+										++sheetCacheMisses;
+
 										lastStep = "Load source EXH/D files";
 										const auto exhPath = Sqex::Sqpack::EntryPathSpec(std::format("exd/{}.exh", exhName));
 										std::unique_ptr<Sqex::Excel::Depth2ExhExdCreator> exCreator;
@@ -1113,11 +1324,13 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 											const auto exhReaderSource = Sqex::Excel::ExhReader(exhName, *creator[exhPath]);
 											if (exhReaderSource.Header.Depth != Sqex::Excel::Exh::Depth::Level2) {
 												progressStoreTarget = ProgressMaxPerTask;
+												storeSheetCacheRecord();
 												return;
 											}
 
 											if (std::ranges::find(exhReaderSource.Languages, Sqex::Language::Unspecified) != exhReaderSource.Languages.end()) {
 												progressStoreTarget = ProgressMaxPerTask;
+												storeSheetCacheRecord();
 												return;
 											}
 
@@ -1165,16 +1378,28 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 											}
 											return Misc::ExcelTransformConfig::PluralColumns();
 										}();
+										// rules applicable to this sheet, indexed by language and then by column index, in the order they were declared
 										const auto exhRowReplacementRules = [&]() {
-											std::map<Sqex::Language, std::vector<ReplacementRule>> res;
+											std::map<Sqex::Language, std::vector<std::vector<const ReplacementRule*>>> res;
 											for (const auto language : fallbackLanguageList)
-												res.emplace(language, std::vector<ReplacementRule>{});
+												res.emplace(language, std::vector<std::vector<const ReplacementRule*>>{});
 
-											for (auto& [language, rules] : rowReplacementRules) {
+											std::map<const srell::u8cregex*, bool> exhNameMatches;
+											for (auto& [language, targets] : rowReplacementRules) {
 												auto& exhRules = res.at(language);
-												for (auto& rule : rules)
-													if (srell::regex_search(exhName, rule.exhNamePattern))
-														exhRules.emplace_back(rule);
+												for (auto& target : targets) {
+													auto [it, inserted] = exhNameMatches.emplace(target.exhNamePattern.get(), false);
+													if (inserted)
+														it->second = srell::regex_search(exhName, *target.exhNamePattern);
+													if (!it->second)
+														continue;
+
+													for (const auto columnIndex : target.columnIndices) {
+														if (exhRules.size() <= columnIndex)
+															exhRules.resize(columnIndex + 1);
+														exhRules[columnIndex].emplace_back(target.rule.get());
+													}
+												}
 											}
 											return res;
 										}();
@@ -1577,11 +1802,12 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 														}
 													}
 
-													for (const auto& rule : rules) {
-														if (!rule.columnIndices.contains(columnIndex))
-															continue;
+													if (columnIndex >= rules.size())
+														continue;
 
-														if (!srell::regex_search(row[columnIndex].String.Escaped(), rule.stringPattern))
+													for (const auto pRule : rules[columnIndex]) {
+														const auto& rule = *pRule;
+														if (!rule.stringPattern->Search(row[columnIndex].String.Escaped()))
 															continue;
 
 														std::vector p = { std::format("{}:{}", exhName, id) };
@@ -1749,19 +1975,14 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 													return;
 
 												lastStep = "Write to filesystem";
-												const auto lock = std::lock_guard(writeMtx);
-												const auto entryLine = std::format("{}\n", nlohmann::json::object({
-													{"FullPath", Utils::StringReplaceAll<std::string>(Utils::ToUtf8(entryPathSpec.FullPath.wstring()), "\\", "/")},
-													{"ModOffset", ttmpdPtr},
-													{"ModSize", len},
-													{"DatFile", "0a0000"},
-													}).dump());
-												ttmplPtr += ttmpl.Write(ttmplPtr, std::span(entryLine));
-												ttmpdPtr += ttmpd.Write(ttmpdPtr, std::span(dv));
+												auto fullPath = Utils::StringReplaceAll<std::string>(Utils::ToUtf8(entryPathSpec.FullPath.wstring()), "\\", "/");
+												sheetCacheRecord.Entries.emplace_back(fullPath);
+												writeEntry(std::move(fullPath), std::span(dv));
 											}
 											currentProgress = 0;
 											progressIndex++;
 											publishProgress();
+											storeSheetCacheRecord();
 										}
 									} catch (const std::exception& e) {
 										if (errorMessage.empty()) {
@@ -1787,6 +2008,9 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 						compressThread.Wait();
 					}
 
+					Logger->Format<LogLevel::Info>(LogCategory::VirtualSqPacks, "[{}/{}] Generated string table: reused {} sheet(s), generated {} sheet(s)",
+						creator.DatExpac, creator.DatName, sheetCacheHits.load(), sheetCacheMisses.load());
+
 					if (progressWindow.GetCancelEvent().Wait(0) == WAIT_OBJECT_0) {
 						try {
 							std::filesystem::remove(cachedDir / "TTMPL.mpl.tmp");
@@ -1813,6 +2037,16 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 					}
 					std::filesystem::rename(cachedDir / "TTMPL.mpl.tmp", cachedDir / "TTMPL.mpl");
 					std::filesystem::rename(cachedDir / "TTMPD.mpd.tmp", cachedDir / "TTMPD.mpd");
+					{
+						auto sheets = nlohmann::json::object();
+						for (const auto& [exhName, record] : sheetCacheRecords) {
+							sheets.emplace(exhName, nlohmann::json::object({
+								{"key", record.Key},
+								{"entries", record.Entries},
+								}));
+						}
+						Utils::SaveJsonToFile(cachedDir / "sheets.json", nlohmann::json::object({{"sheets", std::move(sheets)}}));
+					}
 					Utils::Win32::Handle::FromCreateFile(cachedDir / "sources", GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, 0)
 						.Write(0, currentCacheKeys.data(), currentCacheKeys.size());
 				}
@@ -2012,6 +2246,8 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 					for (const auto& info : Misc::GameInstallationDetector::FindInstallations())
 						fontCreator.ProvideGameDirectory(info.Region, info.RootPath);
 					SetupGeneratedFonts_VerifyRequirements(fontCreator, progressWindow);
+					const auto glyphCache = std::make_shared<Sqex::FontCsv::FreeTypeGlyphCache>(Config->Init.ResolveConfigStorageDirectoryPath() / "FontGlyphCache");
+					fontCreator.UseGlyphCache(glyphCache);
 					fontCreator.Start();
 
 					while (WAIT_TIMEOUT == progressWindow.DoModalLoop(100, { fontCreator.GetWaitableObject() })) {
@@ -2024,6 +2260,23 @@ struct XivAlexander::Apps::MainApp::Internal::VirtualSqPacks::Implementation {
 							progressWindow.UpdateMessage(Utils::ToUtf8(Config->Runtime.GetStringRes(IDS_TITLE_GENERATING_FONTS)));
 					}
 					if (progressWindow.GetCancelEvent().Wait(0) != WAIT_OBJECT_0) {
+						const auto glyphCacheStatistics = glyphCache->GetStatistics();
+						Logger->Format<LogLevel::Info>(LogCategory::VirtualSqPacks,
+							"\t=> Glyph cache: {} hits ({} bytes), {} misses ({} bytes stored)",
+							glyphCacheStatistics.Hits, glyphCacheStatistics.HitBytes, glyphCacheStatistics.Misses, glyphCacheStatistics.StoredBytes);
+						for (const auto& [textureGroupName, resultSet] : fontCreator.GetResult().Result) {
+							const auto& packing = resultSet.PackingStatistics;
+							Logger->Format<LogLevel::Info>(LogCategory::VirtualSqPacks,
+								"\t=> Atlas packing for {}: {} glyphs onto {} pages, {:.1f}% used, {}ms",
+								textureGroupName, packing.GlyphCount, packing.PageCount, packing.Efficiency() * 100.,
+								std::chrono::duration_cast<std::chrono::milliseconds>(packing.Elapsed).count());
+						}
+						try {
+							glyphCache->Save();
+						} catch (const std::exception& e) {
+							Logger->Format<LogLevel::Warning>(LogCategory::VirtualSqPacks, "Failed to save glyph cache: {}", e.what());
+						}
+
 						progressWindow.UpdateMessage(Utils::ToUtf8(Config->Runtime.GetStringRes(IDS_TITLE_COMPRESSING)));
 						Utils::Win32::TpEnvironment pool(L"SetUpGeneratedFonts");
 						const auto streams = fontCreator.GetResult().GetAllStreams();
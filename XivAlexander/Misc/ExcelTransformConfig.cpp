@@ -185,3 +185,160 @@ void XivAlexander::Misc::ExcelTransformConfig::from_json(const nlohmann::json& j
 	o.ignoredCells = j.value("ignoredCells", decltype(o.ignoredCells)());
 	o.rules = j.at("rules").get<decltype(o.rules)>();
 }
+
+// Finds the longest run of bytes that every match of pattern has to contain, giving up on constructs it does not understand.
+// literalOnly is set if the pattern is nothing but that run.
+static std::string FindRequiredLiteral(const std::string& pattern, bool icase, bool& literalOnly) {
+	literalOnly = false;
+
+	std::vector<std::string> runs(1);
+	auto onlyLiterals = true;
+	size_t lastAtomSize = 0;
+	const auto endRun = [&]() {
+		onlyLiterals = false;
+		lastAtomSize = 0;
+		if (!runs.back().empty())
+			runs.emplace_back();
+	};
+	const auto addLiteral = [&](std::string_view bytes) {
+		// Under case-insensitive matching, non-ASCII letters, and 'k' and 's' (KELVIN SIGN and LATIN SMALL LETTER LONG S), have case variants outside ASCII.
+		if (icase && (static_cast<uint8_t>(bytes[0]) >= 0x80 || bytes[0] == 'k' || bytes[0] == 'K' || bytes[0] == 's' || bytes[0] == 'S'))
+			return endRun();
+		runs.back().append(bytes);
+		lastAtomSize = bytes.size();
+	};
+	// Returns the index of the byte closing the class or group opened at i, or npos.
+	const auto skipEnclosed = [&pattern](size_t i) -> size_t {
+		size_t depth = 0;
+		for (auto inClass = false; i < pattern.size(); ++i) {
+			if (pattern[i] == '\\')
+				++i;
+			else if (inClass) {
+				if (pattern[i] == ']') {
+					inClass = false;
+					if (depth == 0)
+						return i;
+				}
+			} else if (pattern[i] == '[')
+				inClass = true;
+			else if (pattern[i] == '(')
+				++depth;
+			else if (pattern[i] == ')' && --depth == 0)
+				return i;
+		}
+		return std::string::npos;
+	};
+
+	for (size_t i = 0; i < pattern.size(); ++i) {
+		switch (const auto c = pattern[i]) {
+			case '|':
+			case ')':
+			case ']':
+			case '}':
+				return {};
+
+			case '^':
+			case '$':
+			case '.':
+				endRun();
+				break;
+
+			case '[':
+			case '(':
+				if ((i = skipEnclosed(i)) == std::string::npos)
+					return {};
+				endRun();
+				break;
+
+			case '*':
+			case '?':
+			case '{':
+				if (c == '{' && (i = pattern.find('}', i)) == std::string::npos)
+					return {};
+				runs.back().resize(runs.back().size() - lastAtomSize);
+				endRun();
+				break;
+
+			case '+':
+				endRun();
+				break;
+
+			case '\\': {
+				if (++i == pattern.size())
+					return {};
+				switch (const auto n = pattern[i]) {
+					case 'd': case 'D': case 's': case 'S': case 'w': case 'W': case 'b': case 'B':
+						endRun();
+						break;
+					case 'n': addLiteral("\n"); break;
+					case 'r': addLiteral("\r"); break;
+					case 't': addLiteral("\t"); break;
+					case 'f': addLiteral("\f"); break;
+					case 'v': addLiteral("\v"); break;
+					default:
+						if (static_cast<uint8_t>(n) >= 0x80 || std::isalnum(static_cast<uint8_t>(n)))
+							return {};
+						addLiteral(std::string_view(&pattern[i], 1));
+				}
+				break;
+			}
+
+			default: {
+				size_t length = 1;
+				if ((c & 0xE0) == 0xC0)
+					length = 2;
+				else if ((c & 0xF0) == 0xE0)
+					length = 3;
+				else if ((c & 0xF8) == 0xF0)
+					length = 4;
+				if (i + length > pattern.size())
+					return {};
+				addLiteral(std::string_view(&pattern[i], length));
+				i += length - 1;
+			}
+		}
+	}
+
+	literalOnly = onlyLiterals;
+	return *std::ranges::max_element(runs, {}, [](const auto& run) { return run.size(); });
+}
+
+XivAlexander::Misc::ExcelTransformConfig::StringPattern::StringPattern(const std::string& pattern, bool icase)
+	: m_icase(icase) {
+	m_requiredLiteral = FindRequiredLiteral(pattern, icase, m_literalOnly);
+	if (!m_literalOnly)
+		m_regex.emplace(pattern, srell::regex_constants::ECMAScript | (icase ? srell::regex_constants::icase : srell::regex_constants::syntax_option_type()));
+}
+
+bool XivAlexander::Misc::ExcelTransformConfig::StringPattern::ContainsRequiredLiteral(std::string_view s) const {
+	if (m_requiredLiteral.empty())
+		return true;
+	if (!m_icase)
+		return s.find(m_requiredLiteral) != std::string_view::npos;
+
+	return !std::ranges::search(s, m_requiredLiteral, [](char a, char b) {
+		return std::tolower(static_cast<uint8_t>(a)) == std::tolower(static_cast<uint8_t>(b));
+	}).empty();
+}
+
+bool XivAlexander::Misc::ExcelTransformConfig::StringPattern::Search(std::string_view s) const {
+	if (!ContainsRequiredLiteral(s))
+		return false;
+	if (m_literalOnly)
+		return true;
+	return srell::regex_search(s.data(), s.data() + s.size(), *m_regex);
+}
+
+std::shared_ptr<const XivAlexander::Misc::ExcelTransformConfig::StringPattern> XivAlexander::Misc::ExcelTransformConfig::PatternCache::GetStringPattern(const std::string& pattern, bool icase) {
+	auto& res = m_stringPatterns[std::make_pair(pattern, icase)];
+	if (!res)
+		res = std::make_shared<StringPattern>(pattern, icase);
+	return res;
+}
+
+std::shared_ptr<const srell::u8cregex> XivAlexander::Misc::ExcelTransformConfig::PatternCache::GetRegex(const std::string& pattern, bool icase) {
+	auto& res = m_regexes[std::make_pair(pattern, icase)];
+	if (!res)
+		res = std::make_shared<srell::u8cregex>(pattern, srell::regex_constants::ECMAScript | (icase ? srell::regex_constants::icase : srell::regex_constants::syntax_option_type()));
+	return res;
+}
@@ -87,4 +87,31 @@ namespace XivAlexander::Misc::ExcelTransformConfig {
 
 	void to_json(nlohmann::json& j, const Config& o);
 	void from_json(const nlohmann::json& j, Config& o);
+
+	// A Rule::stringPattern prepared for being tested against many cells.
+	// Empty and purely literal patterns never reach the regex engine, and other patterns only do so after a literal that every match has to contain is found.
+	class StringPattern {
+		std::string m_requiredLiteral;
+		bool m_icase;
+		bool m_literalOnly;
+		std::optional<srell::u8cregex> m_regex;
+
+	public:
+		StringPattern(const std::string& pattern, bool icase);
+
+		[[nodiscard]] bool Search(std::string_view s) const;
+
+	private:
+		[[nodiscard]] bool ContainsRequiredLiteral(std::string_view s) const;
+	};
+
+	// Compiles each distinct pattern only once, so that the same pattern repeated across rules, target groups and config files shares one compiled object.
+	class PatternCache {
+		std::map<std::pair<std::string, bool>, std::shared_ptr<const StringPattern>> m_stringPatterns;
+		std::map<std::pair<std::string, bool>, std::shared_ptr<const srell::u8cregex>> m_regexes;
+
+	public:
+		std::shared_ptr<const StringPattern> GetStringPattern(const std::string& pattern, bool icase);
+		std::shared_ptr<const srell::u8cregex> GetRegex(const std::string& pattern, bool icase);
+	};
 }
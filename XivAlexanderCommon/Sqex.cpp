@@ -139,15 +139,109 @@ uint64_t Sqex::RandomAccessStream::ReadStreamPartial(uint64_t offset, void* buf,
 	return ReadStreamPartial(offset, buf, length);
 }
 
+void Sqex::RandomAccessStream::ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const {
+	for (auto& request : requests)
+		request.Read = ReadStreamPartial(request.Offset, request.Buffer, request.Length);
+}
+
 void Sqex::RandomAccessStream::ReadStream(uint64_t offset, void* buf, uint64_t length) const {
 	if (ReadStreamPartial(offset, buf, length) != length)
 		throw std::runtime_error("Reached end of stream before reading all of the requested data.");
 }
 
+void* Sqex::VirtualAllocPageCacheBackend::Allocate() {
+	const auto page = VirtualAlloc(nullptr, PageSize(), MEM_COMMIT, PAGE_READWRITE);
+	if (!page)
+		throw std::bad_alloc();
+	return page;
+}
+
+void Sqex::VirtualAllocPageCacheBackend::Discard(void* page) {
+	VirtualAlloc(page, PageSize(), MEM_RESET, PAGE_READWRITE);
+}
+
+bool Sqex::VirtualAllocPageCacheBackend::Reclaim(void* page) {
+	return VirtualAlloc(page, PageSize(), MEM_RESET_UNDO, PAGE_READWRITE);
+}
+
+void Sqex::VirtualAllocPageCacheBackend::Release(void* page) {
+	VirtualFree(page, 0, MEM_RELEASE);
+}
+
+Sqex::SlabPageCacheBackend::SlabPageCacheBackend(size_t pageSize, size_t pagesPerSlab)
+	: PageCacheBackend(pageSize)
+	, m_pagesPerSlab(pagesPerSlab) {
+	if (!pagesPerSlab)
+		throw std::invalid_argument("pagesPerSlab must be a positive number");
+}
+
+void* Sqex::SlabPageCacheBackend::Allocate() {
+	const auto lock = std::lock_guard(m_mtx);
+	if (m_freePages.empty()) {
+		const auto& slab = m_slabs.emplace_back(std::make_unique<uint8_t[]>(PageSize() * m_pagesPerSlab));
+		for (size_t i = m_pagesPerSlab; i-- > 0;)
+			m_freePages.emplace_back(&slab[PageSize() * i]);
+	}
+
+	const auto page = m_freePages.back();
+	m_freePages.pop_back();
+	return page;
+}
+
+void Sqex::SlabPageCacheBackend::Release(void* page) {
+	const auto lock = std::lock_guard(m_mtx);
+	m_freePages.emplace_back(page);
+}
+
 Sqex::BufferedRandomAccessStream::~BufferedRandomAccessStream() {
 	for (const auto addr : m_buffers)
 		if (addr)
-			VirtualFree(addr, 0, MEM_RELEASE);
+			m_backend->Release(addr);
+}
+
+void Sqex::BufferedRandomAccessStream::ReleasePage(size_t pageIndex) const {
+	m_backend->Release(m_buffers[pageIndex]);
+	m_buffers[pageIndex] = nullptr;
+}
+
+void* Sqex::BufferedRandomAccessStream::LoadPage(size_t pageIndex, bool sequential) const {
+	if (const auto buffer = m_buffers[pageIndex]) {
+		if (!m_backend->Reclaim(buffer))
+			m_stream->ReadStreamPartial(static_cast<uint64_t>(pageIndex) * m_bufferSize, buffer, m_bufferSize);
+		return buffer;
+	}
+
+	// When the reader looks sequential, fill the following missing pages with the same read.
+	size_t count = 1;
+	if (sequential) {
+		const auto maxCount = std::min(m_readAheadPageCount + 1, m_maxPageCount);
+		while (count < maxCount && pageIndex + count < m_buffers.size() && !m_buffers[pageIndex + count])
+			++count;
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		if (m_maxPageCount != SIZE_MAX) {
+			while (!m_residentPages.empty() && m_residentPages.size() >= m_maxPageCount) {
+				ReleasePage(m_residentPages.front());
+				m_residentPages.pop_front();
+			}
+			m_residentPages.emplace_back(pageIndex + i);
+		}
+		m_buffers[pageIndex + i] = m_backend->Allocate();
+	}
+
+	if (count == 1) {
+		m_stream->ReadStreamPartial(static_cast<uint64_t>(pageIndex) * m_bufferSize, m_buffers[pageIndex], m_bufferSize);
+	} else {
+		std::vector<uint8_t> buf(m_bufferSize * count);
+		m_stream->ReadStreamPartial(static_cast<uint64_t>(pageIndex) * m_bufferSize, buf.data(), buf.size());
+		for (size_t i = 0; i < count; ++i) {
+			std::copy_n(&buf[m_bufferSize * i], m_bufferSize, static_cast<uint8_t*>(m_buffers[pageIndex + i]));
+			if (i)
+				m_backend->Discard(m_buffers[pageIndex + i]);
+		}
+	}
+	return m_buffers[pageIndex];
 }
 
 uint64_t Sqex::BufferedRandomAccessStream::ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const {
@@ -159,17 +253,13 @@ uint64_t Sqex::BufferedRandomAccessStream::ReadStreamPartial(uint64_t offset, vo
 		if (offset + length > streamSize)
 			length = streamSize - offset;
 
+		const auto sequential = offset == m_lastReadEnd;
+		m_lastReadEnd = offset + length;
+
 		auto out = std::span(static_cast<uint8_t*>(buf), static_cast<size_t>(length));
 		auto relativeOffset = static_cast<size_t>(offset - offset / m_bufferSize * m_bufferSize);
 		for (auto i = offset / m_bufferSize * m_bufferSize; i < offset + length; i += m_bufferSize) {
-			auto& buffer = m_buffers[static_cast<size_t>(i / m_bufferSize)];
-			if (!buffer) {
-				buffer = VirtualAlloc(nullptr, m_bufferSize, MEM_COMMIT, PAGE_READWRITE);
-				m_stream->ReadStreamPartial(i, buffer, m_bufferSize);
-			} else {
-				if (!VirtualAlloc(buffer, m_bufferSize, MEM_RESET_UNDO, PAGE_READWRITE))
-					m_stream->ReadStreamPartial(i, buffer, m_bufferSize);
-			}
+			const auto buffer = LoadPage(static_cast<size_t>(i / m_bufferSize), sequential);
 
 			const auto src = std::span(static_cast<uint8_t*>(buffer), std::min(m_bufferSize, static_cast<size_t>(offset + length - i))).subspan(relativeOffset);
 			const auto available = std::min(src.size_bytes(), out.size_bytes());
@@ -177,7 +267,7 @@ uint64_t Sqex::BufferedRandomAccessStream::ReadStreamPartial(uint64_t offset, vo
 			out = out.subspan(available);
 			relativeOffset = 0;
 
-			VirtualAlloc(buffer, m_bufferSize, MEM_RESET, PAGE_READWRITE);
+			m_backend->Discard(buffer);
 		}
 		return length - out.size_bytes();
 	} else {
@@ -195,9 +285,11 @@ void Sqex::BufferedRandomAccessStream::Flush() const {
 	for (auto& addr : m_buffers) {
 		if (!addr)
 			continue;
-		VirtualFree(addr, 0, MEM_RELEASE);
+		m_backend->Release(addr);
 		addr = nullptr;
 	}
+	m_residentPages.clear();
+	m_lastReadEnd = UINT64_MAX;
 }
 
 Sqex::FileRandomAccessStream::FileRandomAccessStream(Win32::Handle file, uint64_t offset, uint64_t length)
@@ -226,10 +318,7 @@ uint64_t Sqex::FileRandomAccessStream::StreamSize() const {
 	return m_size;
 }
 
-uint64_t Sqex::FileRandomAccessStream::ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const {
-	if (offset >= m_size)
-		return 0;
-
+void Sqex::FileRandomAccessStream::EnsureOpened() const {
 	if (m_initializationMutex) {
 		if (const auto mtx = m_initializationMutex) {
 			const auto lock = std::lock_guard(*mtx);
@@ -239,7 +328,88 @@ uint64_t Sqex::FileRandomAccessStream::ReadStreamPartial(uint64_t offset, void*
 			}
 		}
 	}
+}
+
+uint64_t Sqex::FileRandomAccessStream::ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const {
+	if (offset >= m_size)
+		return 0;
+
+	EnsureOpened();
 
 	const auto available = static_cast<size_t>(std::min(length, m_size - offset));
 	return m_file.Read(m_offset + offset, buf, available, Win32::Handle::PartialIoMode::AllowPartial);
 }
+
+void Sqex::FileRandomAccessStream::ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const {
+	std::vector<BatchReadRequest*> sorted;
+	sorted.reserve(requests.size());
+	for (auto& request : requests) {
+		request.Read = 0;
+		if (request.Offset < m_size && request.Length)
+			sorted.emplace_back(&request);
+	}
+	if (sorted.empty())
+		return;
+
+	EnsureOpened();
+
+	std::ranges::sort(sorted, [](const auto* l, const auto* r) { return l->Offset < r->Offset; });
+
+	std::vector<uint8_t> merged;
+	for (size_t i = 0; i < sorted.size();) {
+		const auto from = sorted[i]->Offset;
+		auto to = from + std::min(sorted[i]->Length, m_size - from);
+
+		auto j = i + 1;
+		for (; j < sorted.size(); ++j) {
+			const auto requestTo = sorted[j]->Offset + std::min(sorted[j]->Length, m_size - sorted[j]->Offset);
+			if (sorted[j]->Offset > to + BatchReadMaxGap || std::max(to, requestTo) - from > BatchReadMaxLength)
+				break;
+			to = std::max(to, requestTo);
+		}
+
+		if (j == i + 1) {
+			sorted[i]->Read = m_file.Read(m_offset + from, sorted[i]->Buffer, static_cast<size_t>(to - from), Win32::Handle::PartialIoMode::AllowPartial);
+
+		} else {
+			merged.resize(static_cast<size_t>(to - from));
+			const auto read = m_file.Read(m_offset + from, merged.data(), merged.size(), Win32::Handle::PartialIoMode::AllowPartial);
+			for (; i < j; ++i) {
+				auto& request = *sorted[i];
+				const auto relativeOffset = static_cast<size_t>(request.Offset - from);
+				if (relativeOffset >= read)
+					continue;
+				request.Read = std::min<uint64_t>(request.Length, read - relativeOffset);
+				std::copy_n(&merged[relativeOffset], static_cast<size_t>(request.Read), static_cast<uint8_t*>(request.Buffer));
+			}
+		}
+		i = j;
+	}
+}
+
+Sqex::MemoryMappedFileRandomAccessStream::MemoryMappedFileRandomAccessStream(std::filesystem::path path)
+	: m_path(std::move(path)) {
+	const auto file = Win32::Handle::FromCreateFile(m_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0);
+	const auto size = file.GetFileSize();
+	if (size > SIZE_MAX)
+		throw std::invalid_argument(std::format("file size({} from {}) does not fit in address space", size, m_path));
+
+	// CreateFileMappingW refuses empty files; nothing to map anyway.
+	if (!size)
+		return;
+
+	// Both file and mapping handles can be closed once the view exists; the view keeps the section alive.
+	const auto mapping = Win32::FileMapping::Create(file);
+	m_view = Win32::FileMapping::View::Create(mapping);
+	m_data = m_view.AsSpan<uint8_t>(static_cast<size_t>(size));
+}
+
+Sqex::MemoryMappedFileRandomAccessStream::~MemoryMappedFileRandomAccessStream() = default;
+
+uint64_t Sqex::MemoryMappedFileRandomAccessStream::ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const {
+	if (offset >= m_data.size())
+		return 0;
+	const auto available = static_cast<size_t>(std::min<uint64_t>(length, m_data.size() - offset));
+	std::copy_n(&m_data[static_cast<size_t>(offset)], available, static_cast<uint8_t*>(buf));
+	return available;
+}
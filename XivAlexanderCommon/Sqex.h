@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <list>
 #include <mutex>
 #include <span>
 #include <type_traits>
@@ -142,6 +143,16 @@ namespace Sqex {
 		[[nodiscard]] virtual uint64_t StreamSize() const = 0;
 		virtual uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const = 0;
 
+		struct BatchReadRequest {
+			uint64_t Offset;
+			void* Buffer;
+			uint64_t Length;
+			uint64_t Read;  // filled by ReadStreamPartialBatch
+		};
+
+		// Performs ReadStreamPartial for every request. Streams over files merge nearby requests into fewer reads.
+		virtual void ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const;
+
 		void ReadStream(uint64_t offset, void* buf, uint64_t length) const;
 
 		template<typename T>
@@ -188,22 +199,88 @@ namespace Sqex {
 		virtual void Flush() const {}
 	};
 
+	// Provides fixed-size pages to BufferedRandomAccessStream.
+	class PageCacheBackend {
+		const size_t m_pageSize;
+
+	public:
+		PageCacheBackend(size_t pageSize) : m_pageSize(pageSize) {}
+		virtual ~PageCacheBackend() = default;
+
+		[[nodiscard]] size_t PageSize() const { return m_pageSize; }
+
+		// Returns a page of undefined contents.
+		virtual void* Allocate() = 0;
+
+		// Lets the backend drop the contents of the page if memory is needed elsewhere.
+		virtual void Discard(void* page) = 0;
+
+		// Makes a discarded page usable again; returns false if its contents have been dropped.
+		virtual bool Reclaim(void* page) = 0;
+
+		virtual void Release(void* page) = 0;
+	};
+
+	// Backs each page with its own VirtualAlloc allocation, and lets the OS take back idle pages using MEM_RESET.
+	class VirtualAllocPageCacheBackend : public PageCacheBackend {
+	public:
+		using PageCacheBackend::PageCacheBackend;
+
+		void* Allocate() override;
+		void Discard(void* page) override;
+		bool Reclaim(void* page) override;
+		void Release(void* page) override;
+	};
+
+	// Carves pages out of heap allocated slabs and never drops contents of its own accord; does not depend on OS paging features.
+	class SlabPageCacheBackend : public PageCacheBackend {
+		const size_t m_pagesPerSlab;
+		std::mutex m_mtx;
+		std::vector<std::unique_ptr<uint8_t[]>> m_slabs;
+		std::vector<void*> m_freePages;
+
+	public:
+		SlabPageCacheBackend(size_t pageSize, size_t pagesPerSlab = 64);
+
+		void* Allocate() override;
+		void Discard(void* page) override {}
+		bool Reclaim(void* page) override { return true; }
+		void Release(void* page) override;
+	};
+
 	class BufferedRandomAccessStream : public RandomAccessStream {
 		const std::shared_ptr<RandomAccessStream> m_stream;
+		const std::shared_ptr<PageCacheBackend> m_backend;
 		const size_t m_bufferSize;
 		const uint64_t m_streamSize;
+		const size_t m_maxPageCount;
+		const size_t m_readAheadPageCount;
 #if INTPTR_MAX == INT64_MAX
 		bool m_bEnableBuffering = true;
 #else
 		bool m_bEnableBuffering = false;
 #endif
 		mutable std::vector<void*> m_buffers;
+		mutable std::list<size_t> m_residentPages;  // least recently loaded first; tracked only when m_maxPageCount is set
+		mutable uint64_t m_lastReadEnd = UINT64_MAX;
+
+		void* LoadPage(size_t pageIndex, bool sequential) const;
+		void ReleasePage(size_t pageIndex) const;
 
 	public:
 		BufferedRandomAccessStream(std::shared_ptr<RandomAccessStream> stream, size_t bufferSize = 16384)
+			: BufferedRandomAccessStream(std::move(stream), std::make_shared<VirtualAllocPageCacheBackend>(bufferSize)) {
+		}
+
+		// maxPageCount limits the number of pages kept at once, releasing the earliest loaded page first.
+		// readAheadPageCount is the number of pages after a missing one to fill with the same read, once reads turn out to be sequential.
+		BufferedRandomAccessStream(std::shared_ptr<RandomAccessStream> stream, std::shared_ptr<PageCacheBackend> backend, size_t maxPageCount = SIZE_MAX, size_t readAheadPageCount = 0)
 			: m_stream(std::move(stream))
-			, m_bufferSize(bufferSize)
+			, m_backend(std::move(backend))
+			, m_bufferSize(m_backend->PageSize())
 			, m_streamSize(m_stream->StreamSize())
+			, m_maxPageCount(maxPageCount)
+			, m_readAheadPageCount(readAheadPageCount)
 			, m_buffers(Align<uint64_t, size_t>(m_streamSize, m_bufferSize).Count) {
 		}
 
@@ -239,6 +316,17 @@ namespace Sqex {
 			return m_stream->ReadStreamPartial(m_offset + offset, buf, length);
 		}
 
+		void ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const override {
+			auto translated = std::vector(requests.begin(), requests.end());
+			for (auto& request : translated) {
+				request.Length = request.Offset >= m_size ? 0 : std::min(request.Length, m_size - request.Offset);
+				request.Offset += m_offset;
+			}
+			m_stream->ReadStreamPartialBatch(translated);
+			for (size_t i = 0; i < requests.size(); ++i)
+				requests[i].Read = translated[i].Read;
+		}
+
 		std::string DescribeState() const override {
 			return std::format("RandomAccessStreamPartialView({}, {}, {})", m_stream->DescribeState(), m_offset, m_size);
 		}
@@ -251,19 +339,48 @@ namespace Sqex {
 		const uint64_t m_offset;
 		const uint64_t m_size;
 
+		void EnsureOpened() const;
+
 	public:
+		// Requests at most this far apart get merged into a single read by ReadStreamPartialBatch.
+		static constexpr uint64_t BatchReadMaxGap = 4096;
+
+		// Merged reads in ReadStreamPartialBatch do not grow beyond this size.
+		static constexpr uint64_t BatchReadMaxLength = 1048576;
+
 		FileRandomAccessStream(Win32::Handle file, uint64_t offset = 0, uint64_t length = UINT64_MAX);
 		FileRandomAccessStream(std::filesystem::path path, uint64_t offset = 0, uint64_t length = UINT64_MAX, bool openImmediately = true);
 		~FileRandomAccessStream() override;
 
 		[[nodiscard]] uint64_t StreamSize() const override;
 		uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const override;
+		void ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const override;
 
 		std::string DescribeState() const override {
 			return std::format("FileRandomAccessStream({}, {}, {})", m_file.GetPathName(), m_offset, m_size);
 		}
 	};
 
+	class MemoryMappedFileRandomAccessStream : public RandomAccessStream {
+		const std::filesystem::path m_path;
+		Win32::FileMapping::View m_view;
+		std::span<const uint8_t> m_data;
+
+	public:
+		MemoryMappedFileRandomAccessStream(std::filesystem::path path);
+		~MemoryMappedFileRandomAccessStream() override;
+
+		[[nodiscard]] uint64_t StreamSize() const override { return m_data.size(); }
+		uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const override;
+
+		// Directly points into the mapped view; valid for as long as this stream is alive.
+		[[nodiscard]] std::span<const uint8_t> AsSpan() const { return m_data; }
+
+		std::string DescribeState() const override {
+			return std::format("MemoryMappedFileRandomAccessStream({}, {})", m_path, m_data.size());
+		}
+	};
+
 	class MemoryRandomAccessStream : public RandomAccessStream {
 		std::vector<uint8_t> m_buffer;
 		std::span<uint8_t> m_view;
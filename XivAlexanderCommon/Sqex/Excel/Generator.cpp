@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Excel/Generator.h"
 
+#include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
+
 Sqex::Excel::Depth2ExhExdCreator::Depth2ExhExdCreator(std::string name, std::vector<Exh::Column> columns, const Exh::ExhFlag& flag)
 	: Name(std::move(name))
 	, Columns(std::move(columns))
@@ -66,7 +68,83 @@ void Sqex::Excel::Depth2ExhExdCreator::SetRow(uint32_t id, Language language, st
 		target = std::move(row);
 }
 
-std::pair<Sqex::Sqpack::EntryPathSpec, std::vector<char>> Sqex::Excel::Depth2ExhExdCreator::Flush(uint32_t startId, std::map<uint32_t, std::vector<char>> rows, Language language) {
+std::vector<char> Sqex::Excel::Depth2ExhExdCreator::SerializeRow(const std::vector<ExdColumn>& columns) const {
+	std::vector<char> row(sizeof Exd::RowHeader + FixedDataSize);
+
+	const auto fixedDataOffset = sizeof Exd::RowHeader;
+	const auto variableDataOffset = fixedDataOffset + FixedDataSize;
+
+	for (size_t i = 0; i < columns.size(); ++i) {
+		const auto& column = columns[i];
+		const auto& columnDefinition = Columns[i];
+		size_t validSize = 0;
+		switch (columnDefinition.Type) {
+			case Exh::String:
+			{
+				const auto stringOffset = BE(static_cast<uint32_t>(row.size() - variableDataOffset));
+				std::copy_n(reinterpret_cast<const char*>(&stringOffset), 4, &row[fixedDataOffset + columnDefinition.Offset]);
+				row.reserve(row.size() + column.String.Escaped().size() + 1);
+				row.insert(row.end(), column.String.Escaped().begin(), column.String.Escaped().end());
+				row.push_back(0);
+				break;
+			}
+
+			case Exh::Bool:
+			case Exh::Int8:
+			case Exh::UInt8:
+				validSize = 1;
+				break;
+
+			case Exh::Int16:
+			case Exh::UInt16:
+				validSize = 2;
+				break;
+
+			case Exh::Int32:
+			case Exh::UInt32:
+			case Exh::Float32:
+				validSize = 4;
+				break;
+
+			case Exh::Int64:
+			case Exh::UInt64:
+				validSize = 8;
+				break;
+
+			case Exh::PackedBool0:
+			case Exh::PackedBool1:
+			case Exh::PackedBool2:
+			case Exh::PackedBool3:
+			case Exh::PackedBool4:
+			case Exh::PackedBool5:
+			case Exh::PackedBool6:
+			case Exh::PackedBool7:
+				if (column.boolean)
+					row[fixedDataOffset + columnDefinition.Offset] |= (1 << (static_cast<int>(column.Type) - static_cast<int>(Exh::PackedBool0)));
+				else
+					row[fixedDataOffset + columnDefinition.Offset] &= ~((1 << (static_cast<int>(column.Type) - static_cast<int>(Exh::PackedBool0))));
+				break;
+		}
+		if (validSize) {
+			const auto target = std::span(row).subspan(fixedDataOffset + columnDefinition.Offset, validSize);
+			std::copy_n(&column.Buffer[0], validSize, &target[0]);
+			// ReSharper disable once CppUseRangeAlgorithm
+			std::reverse(target.begin(), target.end());
+		}
+	}
+	row.resize(Sqex::Align<size_t>(row.size(), 4));
+
+	auto& rowHeader = *reinterpret_cast<Exd::RowHeader*>(&row[0]);
+	rowHeader.DataSize = static_cast<uint32_t>(row.size() - sizeof rowHeader);
+	rowHeader.SubRowCount = 1;
+
+	if (reinterpret_cast<const Exd::RowHeader*>(&row[0])->DataSize != row.size() - 6)
+		__debugbreak();
+
+	return row;
+}
+
+std::pair<Sqex::Sqpack::EntryPathSpec, std::vector<char>> Sqex::Excel::Depth2ExhExdCreator::Flush(uint32_t startId, std::vector<std::pair<uint32_t, std::vector<char>>> rows, Language language) const {
 	Exd::Header exdHeader;
 	const auto exdHeaderSpan = span_cast<char>(1, &exdHeader);
 	memcpy(exdHeader.Signature, Exd::Header::Signature_Value, 4);
@@ -131,124 +209,54 @@ std::pair<Sqex::Sqpack::EntryPathSpec, std::vector<char>> Sqex::Excel::Depth2Exh
 
 std::map<Sqex::Sqpack::EntryPathSpec, std::vector<char>, Sqex::Sqpack::EntryPathSpec::FullPathComparator> Sqex::Excel::Depth2ExhExdCreator::Compile(size_t divideUnit) {
 	std::map<Sqpack::EntryPathSpec, std::vector<char>, Sqpack::EntryPathSpec::FullPathComparator> result;
-	std::vector<std::pair<Exh::Pagination, std::vector<uint32_t>>> pages;
-	for (const auto id : Data | std::views::keys) {
+
+	// Rows sorted by id; each page refers to a range of it.
+	std::vector<std::pair<uint32_t, const std::map<Language, std::vector<ExdColumn>>*>> rowStore;
+	rowStore.reserve(Data.size());
+	for (const auto& [id, rowSet] : Data)
+		rowStore.emplace_back(id, &rowSet);
+
+	std::vector<std::pair<Exh::Pagination, std::pair<size_t, size_t>>> pages;
+	for (size_t i = 0; i < rowStore.size(); ++i) {
+		const auto id = rowStore[i].first;
 		if (pages.empty()) {
-			pages.emplace_back();
-		} else if (pages.back().second.size() == divideUnit || DivideAtIds.find(id) != DivideAtIds.end()) {
-			pages.back().first.RowCountWithSkip = pages.back().second.back() - pages.back().second.front() + 1;
-			pages.emplace_back();
+			pages.emplace_back(Exh::Pagination{}, std::make_pair(i, i));
+		} else if (pages.back().second.second - pages.back().second.first == divideUnit || DivideAtIds.find(id) != DivideAtIds.end()) {
+			pages.back().first.RowCountWithSkip = rowStore[pages.back().second.second - 1].first - pages.back().first.StartId + 1;
+			pages.emplace_back(Exh::Pagination{}, std::make_pair(i, i));
 		}
 
-		if (pages.back().second.empty())
+		if (pages.back().second.first == pages.back().second.second)
 			pages.back().first.StartId = id;
-		pages.back().second.push_back(id);
+		pages.back().second.second = i + 1;
 	}
 	if (pages.empty())
 		return {};
-	pages.back().first.RowCountWithSkip = pages.back().second.back() - pages.back().second.front() + 1;
-
-	for (const auto& page : pages) {
-		for (const auto language : Languages) {
-			std::map<uint32_t, std::vector<char>> rows;
-			for (const auto id : page.second) {
-				std::vector<char> row(sizeof Exd::RowHeader + FixedDataSize);
-
-				const auto fixedDataOffset = sizeof Exd::RowHeader;
-				const auto variableDataOffset = fixedDataOffset + FixedDataSize;
-
-				auto sourceLanguage = language;
-				auto& rowSet = Data[id];
-				if (rowSet.find(sourceLanguage) == rowSet.end()) {
-					sourceLanguage = Language::Unspecified;
-					for (auto lang : FillMissingLanguageFrom) {
-						if (rowSet.find(lang) == rowSet.end()) {
-							sourceLanguage = lang;
-							break;
-						}
-					}
-					if (sourceLanguage == Language::Unspecified)
-						continue;
-				}
-
-				auto& columns = rowSet[sourceLanguage];
-				if (columns.empty())
-					continue;
-
-				for (size_t i = 0; i < columns.size(); ++i) {
-					auto& column = columns[i];
-					const auto& columnDefinition = Columns[i];
-					switch (columnDefinition.Type) {
-						case Exh::String:
-						{
-							const auto stringOffset = BE(static_cast<uint32_t>(row.size() - variableDataOffset));
-							std::copy_n(reinterpret_cast<const char*>(&stringOffset), 4, &row[fixedDataOffset + columnDefinition.Offset]);
-							row.reserve(row.size() + column.String.Escaped().size() + 1);
-							row.insert(row.end(), column.String.Escaped().begin(), column.String.Escaped().end());
-							row.push_back(0);
-							column.ValidSize = 0;
-							break;
-						}
-
-						case Exh::Bool:
-						case Exh::Int8:
-						case Exh::UInt8:
-							column.ValidSize = 1;
-							break;
-
-						case Exh::Int16:
-						case Exh::UInt16:
-							column.ValidSize = 2;
-							break;
-
-						case Exh::Int32:
-						case Exh::UInt32:
-						case Exh::Float32:
-							column.ValidSize = 4;
-							break;
-
-						case Exh::Int64:
-						case Exh::UInt64:
-							column.ValidSize = 8;
-							break;
-
-						case Exh::PackedBool0:
-						case Exh::PackedBool1:
-						case Exh::PackedBool2:
-						case Exh::PackedBool3:
-						case Exh::PackedBool4:
-						case Exh::PackedBool5:
-						case Exh::PackedBool6:
-						case Exh::PackedBool7:
-							column.ValidSize = 0;
-							if (column.boolean)
-								row[fixedDataOffset + columnDefinition.Offset] |= (1 << (static_cast<int>(column.Type) - static_cast<int>(Exh::PackedBool0)));
-							else
-								row[fixedDataOffset + columnDefinition.Offset] &= ~((1 << (static_cast<int>(column.Type) - static_cast<int>(Exh::PackedBool0))));
-							break;
-					}
-					if (column.ValidSize) {
-						const auto target = std::span(row).subspan(fixedDataOffset + columnDefinition.Offset, column.ValidSize);
-						std::copy_n(&column.Buffer[0], column.ValidSize, &target[0]);
-						// ReSharper disable once CppUseRangeAlgorithm
-						std::reverse(target.begin(), target.end());
-					}
-				}
-				row.resize(Sqex::Align<size_t>(row.size(), 4));
-
-				auto& rowHeader = *reinterpret_cast<Exd::RowHeader*>(&row[0]);
-				rowHeader.DataSize = static_cast<uint32_t>(row.size() - sizeof rowHeader);
-				rowHeader.SubRowCount = 1;
-
-				if (reinterpret_cast<const Exd::RowHeader*>(&row[0])->DataSize != row.size() - 6)
-					__debugbreak();
-
-				rows.emplace(id, std::move(row));
-			}
-			if (rows.empty())
+	pages.back().first.RowCountWithSkip = rowStore[pages.back().second.second - 1].first - pages.back().first.StartId + 1;
+
+	// Every (page, language) pair compiles into its own EXD file independently of the others.
+	// A row missing the requested language is left out; callers fill in missing languages before compiling.
+	std::vector<std::optional<std::pair<Sqpack::EntryPathSpec, std::vector<char>>>> exdFiles(pages.size() * Languages.size());
+	Utils::Win32::ParallelFor(exdFiles.size(), [&](size_t index) {
+		const auto& [pagination, range] = pages[index / Languages.size()];
+		const auto language = Languages[index % Languages.size()];
+
+		std::vector<std::pair<uint32_t, std::vector<char>>> rows;
+		rows.reserve(range.second - range.first);
+		for (auto i = range.first; i < range.second; ++i) {
+			const auto& [id, rowSet] = rowStore[i];
+			const auto it = rowSet->find(language);
+			if (it == rowSet->end() || it->second.empty())
 				continue;
-			result.emplace(Flush(page.first.StartId, std::move(rows), language));
+
+			rows.emplace_back(id, SerializeRow(it->second));
 		}
+		if (!rows.empty())
+			exdFiles[index] = Flush(pagination.StartId, std::move(rows), language);
+	});
+	for (auto& exdFile : exdFiles) {
+		if (exdFile)
+			result.emplace(std::move(*exdFile));
 	}
 
 	{
@@ -22,7 +22,8 @@ namespace Sqex::Excel {
 		void SetRow(uint32_t id, Language language, std::vector<ExdColumn> row, bool replace = true);
 
 	private:
-		std::pair<Sqpack::EntryPathSpec, std::vector<char>> Flush(uint32_t startId, std::map<uint32_t, std::vector<char>> rows, Language language);
+		[[nodiscard]] std::vector<char> SerializeRow(const std::vector<ExdColumn>& columns) const;
+		[[nodiscard]] std::pair<Sqpack::EntryPathSpec, std::vector<char>> Flush(uint32_t startId, std::vector<std::pair<uint32_t, std::vector<char>>> rows, Language language) const;
 
 	public:
 		std::map<Sqpack::EntryPathSpec, std::vector<char>, Sqpack::EntryPathSpec::FullPathComparator> Compile(size_t divideUnit = SIZE_MAX);
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Excel/Reader.h"
 
+#include <emmintrin.h>
+
 Sqex::Excel::ExlReader::ExlReader(const RandomAccessStream& stream) {
 	std::string data(static_cast<size_t>(stream.StreamSize()), '\0');
 	stream.ReadStream(0, std::span(data));
@@ -114,12 +116,36 @@ Sqex::Excel::ExdReader::ExdReader(const ExhReader& exh, std::shared_ptr<const Ra
 	, m_depth(exh.Header.Depth)
 	, Header(m_stream->ReadStream<Exd::Header>(0))
 	, ColumnDefinitions(exh.Columns) {
+	m_data = m_stream->ReadStreamIntoVector<char>(0);
+
 	const auto count = Header.IndexSize / sizeof Exd::RowLocator;
+	if (sizeof Header + count * sizeof Exd::RowLocator > m_data.size())
+		throw CorruptDataException("Row locators out of range");
+
 	m_rowLocators.reserve(count);
-	for (const auto& locator : m_stream->ReadStreamIntoVector<Exd::RowLocator>(sizeof Header, count)) {
+	for (const auto& locator : std::span(reinterpret_cast<const Exd::RowLocator*>(&m_data[sizeof Header]), count)) {
 		m_rowLocators.emplace_back(std::make_pair(locator.RowId.Value(), locator.Offset.Value()));
 	}
 	std::ranges::sort(m_rowLocators);
+
+	for (const auto& offset : m_rowLocators | std::views::values) {
+		if (offset + sizeof Exd::RowHeader > m_data.size())
+			throw CorruptDataException("Row out of range");
+
+		const auto& rowHeader = *reinterpret_cast<const Exd::RowHeader*>(&m_data[offset]);
+		if (offset + sizeof rowHeader + rowHeader.DataSize > m_data.size())
+			throw CorruptDataException("Row data out of range");
+
+		if (m_depth == Exh::Level3) {
+			if (rowHeader.SubRowCount * (2 + m_fixedDataSize) > rowHeader.DataSize)
+				throw CorruptDataException("Subrows out of range");
+			m_valueCount += rowHeader.SubRowCount;
+		} else {
+			if (m_fixedDataSize > rowHeader.DataSize)
+				throw CorruptDataException("Fixed data out of range");
+			m_valueCount += 1;
+		}
+	}
 }
 
 Sqex::Excel::ExdColumn Sqex::Excel::ExdReader::TranslateColumn(const Exh::Column& columnDefinition, std::span<const char> fixedData, std::span<const char> fullData) const {
@@ -176,15 +202,15 @@ Sqex::Excel::ExdColumn Sqex::Excel::ExdReader::TranslateColumn(const Exh::Column
 	return column;
 }
 
-std::pair<Sqex::Excel::Exd::RowHeader, std::vector<char>> Sqex::Excel::ExdReader::ReadRowRaw(uint32_t index) const {
+std::pair<Sqex::Excel::Exd::RowHeader, std::span<const char>> Sqex::Excel::ExdReader::ReadRowView(uint32_t index) const {
 	const auto it = std::ranges::lower_bound(m_rowLocators, std::make_pair(index, 0U), [](const auto& l, const auto& r) {
 		return l.first < r.first;
 	});
 	if (it == m_rowLocators.end() || it->first != index)
 		throw std::out_of_range("index out of range");
 
-	const auto rowHeader = m_stream->ReadStream<Exd::RowHeader>(it->second);
-	return std::make_pair(rowHeader, m_stream->ReadStreamIntoVector<char>(it->second + sizeof rowHeader, rowHeader.DataSize));
+	const auto& rowHeader = *reinterpret_cast<const Exd::RowHeader*>(&m_data[it->second]);
+	return std::make_pair(rowHeader, std::span(m_data).subspan(it->second + sizeof rowHeader, rowHeader.DataSize));
 }
 
 std::vector<Sqex::Excel::ExdColumn> Sqex::Excel::ExdReader::ReadDepth2(uint32_t index) const {
@@ -192,14 +218,15 @@ std::vector<Sqex::Excel::ExdColumn> Sqex::Excel::ExdReader::ReadDepth2(uint32_t
 		throw std::invalid_argument("Not a 2nd depth sheet");
 
 	std::vector<ExdColumn> result;
-	const auto [rowHeader, buffer] = ReadRowRaw(index);
-	const auto fixedData = std::span(buffer).subspan(0, m_fixedDataSize);
+	const auto [rowHeader, buffer] = ReadRowView(index);
+	const auto fixedData = buffer.subspan(0, m_fixedDataSize);
 
 	if (rowHeader.SubRowCount != 1)
 		throw CorruptDataException("SubRowCount > 1 on 2nd depth sheet");
 
+	result.reserve(ColumnDefinitions->size());
 	for (const auto& columnDefinition : *ColumnDefinitions)
-		result.emplace_back(TranslateColumn(columnDefinition, fixedData, std::span(buffer)));
+		result.emplace_back(TranslateColumn(columnDefinition, fixedData, buffer));
 
 	return result;
 }
@@ -209,15 +236,17 @@ std::vector<std::vector<Sqex::Excel::ExdColumn>> Sqex::Excel::ExdReader::ReadDep
 		throw std::invalid_argument("Not a 3rd depth sheet");
 
 	std::vector<std::vector<ExdColumn>> result;
-	const auto [rowHeader, buffer] = ReadRowRaw(index);
+	const auto [rowHeader, buffer] = ReadRowView(index);
 
+	result.reserve(rowHeader.SubRowCount);
 	for (size_t i = 0, i_ = rowHeader.SubRowCount; i < i_; ++i) {
 		const auto baseOffset = i * (2 + m_fixedDataSize);
-		const auto fixedData = std::span(buffer).subspan(2 + baseOffset, m_fixedDataSize);
+		const auto fixedData = buffer.subspan(2 + baseOffset, m_fixedDataSize);
 
 		std::vector<ExdColumn> row;
+		row.reserve(ColumnDefinitions->size());
 		for (const auto& columnDefinition : *ColumnDefinitions)
-			row.emplace_back(TranslateColumn(columnDefinition, fixedData, std::span(buffer)));
+			row.emplace_back(TranslateColumn(columnDefinition, fixedData, buffer));
 		result.emplace_back(std::move(row));
 	}
 	return result;
@@ -229,3 +258,130 @@ std::vector<uint32_t> Sqex::Excel::ExdReader::GetIds() const {
 		ids.emplace_back(id);
 	return ids;
 }
+
+// Converts packed big-endian values to native byte order in place, 16 bytes at a time.
+static void ByteSwapInPlace(std::span<char> data, size_t valueSize) {
+	if (valueSize == 1)
+		return;
+
+	size_t i = 0;
+	for (; i + 16 <= data.size(); i += 16) {
+		auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[i]));
+		if (valueSize == 4) {
+			v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+			v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		} else if (valueSize == 8) {
+			v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+			v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+		}
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&data[i]), v);
+	}
+	for (; i < data.size(); i += valueSize)
+		std::reverse(data.data() + i, data.data() + i + valueSize);
+}
+
+void Sqex::Excel::ExdReader::ExtractColumnBytes(size_t columnIndex, size_t valueSize, std::span<char> out) const {
+	const auto& columnDefinition = ColumnDefinitions->at(columnIndex);
+	const auto type = columnDefinition.Type.Value();
+	const size_t offset = columnDefinition.Offset;
+
+	size_t columnSize;
+	switch (type) {
+		case Exh::Bool:
+		case Exh::Int8:
+		case Exh::UInt8:
+			columnSize = 1;
+			break;
+
+		case Exh::Int16:
+		case Exh::UInt16:
+			columnSize = 2;
+			break;
+
+		case Exh::Int32:
+		case Exh::UInt32:
+		case Exh::Float32:
+			columnSize = 4;
+			break;
+
+		case Exh::Int64:
+		case Exh::UInt64:
+			columnSize = 8;
+			break;
+
+		case Exh::PackedBool0:
+		case Exh::PackedBool1:
+		case Exh::PackedBool2:
+		case Exh::PackedBool3:
+		case Exh::PackedBool4:
+		case Exh::PackedBool5:
+		case Exh::PackedBool6:
+		case Exh::PackedBool7:
+			columnSize = 1;
+			break;
+
+		case Exh::String:
+			throw std::invalid_argument("Use ExtractStringColumn for string columns");
+
+		default:
+			throw CorruptDataException(std::format("Invald column type {}", static_cast<uint32_t>(type)));
+	}
+	if (valueSize != columnSize)
+		throw std::invalid_argument(std::format("Column {} is {} byte(s) long, but {} byte(s) were requested", columnIndex, columnSize, valueSize));
+	if (offset + columnSize > m_fixedDataSize)
+		throw CorruptDataException("Column out of range");
+	if (out.size() != m_valueCount * valueSize)
+		throw std::invalid_argument("Output size mismatch");
+
+	auto ptr = out.data();
+	const auto gather = [&](size_t fixedDataOffset) {
+		std::copy_n(&m_data[fixedDataOffset + offset], columnSize, ptr);
+		ptr += columnSize;
+	};
+	for (const auto& rowOffset : m_rowLocators | std::views::values) {
+		const auto dataOffset = rowOffset + sizeof Exd::RowHeader;
+		if (m_depth == Exh::Level3) {
+			const auto subRowCount = reinterpret_cast<const Exd::RowHeader*>(&m_data[rowOffset])->SubRowCount.Value();
+			for (size_t i = 0; i < subRowCount; ++i)
+				gather(dataOffset + i * (2 + m_fixedDataSize) + 2);
+		} else
+			gather(dataOffset);
+	}
+
+	if (type >= Exh::PackedBool0 && type <= Exh::PackedBool7) {
+		const auto mask = static_cast<char>(1 << (type - Exh::PackedBool0));
+		for (auto& c : out)
+			c = (c & mask) ? 1 : 0;
+	} else
+		ByteSwapInPlace(out, columnSize);
+}
+
+std::vector<std::string_view> Sqex::Excel::ExdReader::ExtractStringColumn(size_t columnIndex) const {
+	const auto& columnDefinition = ColumnDefinitions->at(columnIndex);
+	if (columnDefinition.Type != Exh::String)
+		throw std::invalid_argument(std::format("Column {} is not a string column", columnIndex));
+	const size_t offset = columnDefinition.Offset;
+	if (offset + 4 > m_fixedDataSize)
+		throw CorruptDataException("Column out of range");
+
+	std::vector<std::string_view> result;
+	result.reserve(m_valueCount);
+	for (const auto& rowOffset : m_rowLocators | std::views::values) {
+		const auto& rowHeader = *reinterpret_cast<const Exd::RowHeader*>(&m_data[rowOffset]);
+		const auto rowData = std::span(m_data).subspan(rowOffset + sizeof rowHeader, rowHeader.DataSize);
+		const auto gather = [&](size_t fixedDataOffset) {
+			const auto stringOffset = m_fixedDataSize + *reinterpret_cast<const BE<uint32_t>*>(&rowData[fixedDataOffset + offset]);
+			if (stringOffset >= rowData.size())
+				throw CorruptDataException("String out of range");
+			const auto str = rowData.subspan(stringOffset);
+			result.emplace_back(str.data(), std::find(str.begin(), str.end(), '\0') - str.begin());
+		};
+		if (m_depth == Exh::Level3) {
+			for (size_t i = 0, i_ = rowHeader.SubRowCount; i < i_; ++i)
+				gather(i * (2 + m_fixedDataSize) + 2);
+		} else
+			gather(0);
+	}
+	return result;
+}
@@ -60,6 +60,8 @@ namespace Sqex::Excel {
 		const size_t m_fixedDataSize;
 		const Exh::Depth m_depth;
 		std::vector<std::pair<uint32_t, uint32_t>> m_rowLocators;
+		std::vector<char> m_data;
+		size_t m_valueCount = 0;
 
 	public:
 		const Exd::Header Header;
@@ -70,13 +72,32 @@ namespace Sqex::Excel {
 	private:
 		[[nodiscard]] ExdColumn TranslateColumn(const Exh::Column& columnDefinition, std::span<const char> fixedData, std::span<const char> fullData) const;
 
-		[[nodiscard]] std::pair<Exd::RowHeader, std::vector<char>> ReadRowRaw(uint32_t index) const;
+		void ExtractColumnBytes(size_t columnIndex, size_t valueSize, std::span<char> out) const;
 
 	public:
+		// Returned span points into the page held by this reader, and stays valid for as long as the reader does.
+		[[nodiscard]] std::pair<Exd::RowHeader, std::span<const char>> ReadRowView(uint32_t index) const;
+
 		[[nodiscard]] std::vector<ExdColumn> ReadDepth2(uint32_t index) const;
 
 		[[nodiscard]] std::vector<std::vector<ExdColumn>> ReadDepth3(uint32_t index) const;
 
 		[[nodiscard]] std::vector<uint32_t> GetIds() const;
+
+		// Number of values a column holds: one per row, or one per subrow on 3rd depth sheets.
+		[[nodiscard]] size_t GetValueCount() const { return m_valueCount; }
+
+		// Extracts a column of every row (or subrow) in the order of GetIds, converted to native byte order.
+		// T must be as big as the column type; bool and packed bool columns are extracted as uint8_t, as std::vector<bool> has no storage to write into.
+		// Values of packed bool columns are 0 or 1.
+		template<typename T> requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+		[[nodiscard]] std::vector<T> ExtractColumn(size_t columnIndex) const {
+			std::vector<T> result(m_valueCount);
+			ExtractColumnBytes(columnIndex, sizeof(T), std::span(reinterpret_cast<char*>(result.data()), result.size() * sizeof(T)));
+			return result;
+		}
+
+		// Extracts escaped SeString bytes of a string column of every row (or subrow), pointing into the page held by this reader.
+		[[nodiscard]] std::vector<std::string_view> ExtractStringColumn(size_t columnIndex) const;
 	};
 }
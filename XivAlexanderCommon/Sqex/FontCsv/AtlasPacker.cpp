@@ -0,0 +1,272 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/FontCsv/AtlasPacker.h"
+
+namespace {
+	// Replicates the layout FontCsvCreator always had, so that existing configurations produce identical textures.
+	class ShelfAtlasPacker : public Sqex::FontCsv::AtlasPacker {
+		uint16_t m_x;
+		uint16_t m_y;
+		uint16_t m_lineHeight = 0;
+		bool m_empty = true;
+		bool m_full = false;
+
+	public:
+		ShelfAtlasPacker(uint16_t width, uint16_t height, uint16_t glyphGap)
+			: AtlasPacker(width, height, glyphGap)
+			, m_x(glyphGap)
+			, m_y(glyphGap) {
+		}
+
+		std::optional<Position> Insert(uint16_t width, uint16_t height, uint16_t gap) override {
+			if (m_full)
+				return std::nullopt;
+
+			if (!m_empty) {
+				if (static_cast<size_t>(0) + m_x + width + gap >= Width) {
+					m_x = gap;
+					m_y += m_lineHeight + gap + 1;  // Account for rounding errors
+					m_lineHeight = 0;
+				}
+				if (m_y + height + gap + 1 >= Height) {
+					m_full = true;
+					return std::nullopt;
+				}
+			}
+			m_empty = false;
+
+			m_x = std::max(m_x, gap);
+			m_y = std::max(m_y, gap);
+
+			const auto res = Position{ m_x, m_y };
+			m_x += width + GlyphGap;
+			m_lineHeight = std::max(m_lineHeight, height);
+			return res;
+		}
+	};
+
+	// Both of the following place glyphs padded by their gap on the top and left, and by an extra row on the bottom as Shelf does,
+	// into an area that leaves GlyphGap pixels free on the right and the bottom of the page.
+
+	class SkylineAtlasPacker : public Sqex::FontCsv::AtlasPacker {
+		struct Segment {
+			int X;
+			int Y;
+			int Width;
+		};
+
+		const int m_binWidth;
+		const int m_binHeight;
+		std::vector<Segment> m_skyline;
+
+		// Returns the lowest y at which a rectangle can rest on the skyline starting from segment index, or -1 if it does not fit.
+		[[nodiscard]] int Fit(size_t index, int width, int height) const {
+			if (m_skyline[index].X + width > m_binWidth)
+				return -1;
+
+			auto y = 0;
+			for (auto remaining = width; remaining > 0; remaining -= m_skyline[index].Width, ++index) {
+				y = std::max(y, m_skyline[index].Y);
+				if (y + height > m_binHeight)
+					return -1;
+			}
+			return y;
+		}
+
+	public:
+		SkylineAtlasPacker(uint16_t width, uint16_t height, uint16_t glyphGap)
+			: AtlasPacker(width, height, glyphGap)
+			, m_binWidth(width - glyphGap)
+			, m_binHeight(height - glyphGap)
+			, m_skyline{ Segment{ 0, 0, std::max(0, m_binWidth) } } {
+		}
+
+		std::optional<Position> Insert(uint16_t width, uint16_t height, uint16_t gap) override {
+			const auto paddedWidth = width + gap;
+			const auto paddedHeight = height + gap + 1;
+
+			auto bestIndex = SIZE_MAX;
+			auto bestBottom = INT_MAX, bestSegmentWidth = INT_MAX, bestY = 0;
+			for (size_t i = 0; i < m_skyline.size(); ++i) {
+				const auto y = Fit(i, paddedWidth, paddedHeight);
+				if (y < 0)
+					continue;
+
+				const auto bottom = y + paddedHeight;
+				if (bottom < bestBottom || (bottom == bestBottom && m_skyline[i].Width < bestSegmentWidth)) {
+					bestIndex = i;
+					bestBottom = bottom;
+					bestSegmentWidth = m_skyline[i].Width;
+					bestY = y;
+				}
+			}
+			if (bestIndex == SIZE_MAX)
+				return std::nullopt;
+
+			const auto x = m_skyline[bestIndex].X;
+			m_skyline.insert(m_skyline.begin() + static_cast<ptrdiff_t>(bestIndex), Segment{ x, bestBottom, paddedWidth });
+
+			// Cut away what the new segment covers from the segments after it.
+			for (auto i = bestIndex + 1; i < m_skyline.size();) {
+				const auto overlap = x + paddedWidth - m_skyline[i].X;
+				if (overlap <= 0)
+					break;
+				m_skyline[i].X += overlap;
+				m_skyline[i].Width -= overlap;
+				if (m_skyline[i].Width > 0)
+					break;
+				m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i));
+			}
+
+			for (size_t i = 0; i + 1 < m_skyline.size();) {
+				if (m_skyline[i].Y == m_skyline[i + 1].Y) {
+					m_skyline[i].Width += m_skyline[i + 1].Width;
+					m_skyline.erase(m_skyline.begin() + static_cast<ptrdiff_t>(i) + 1);
+				} else
+					++i;
+			}
+
+			return Position{ static_cast<uint16_t>(x + gap), static_cast<uint16_t>(bestY + gap) };
+		}
+	};
+
+	class MaxRectsAtlasPacker : public Sqex::FontCsv::AtlasPacker {
+		struct Rect {
+			int X;
+			int Y;
+			int Width;
+			int Height;
+
+			[[nodiscard]] bool Intersects(const Rect& r) const {
+				return X < r.X + r.Width && r.X < X + Width && Y < r.Y + r.Height && r.Y < Y + Height;
+			}
+
+			[[nodiscard]] bool Contains(const Rect& r) const {
+				return X <= r.X && Y <= r.Y && r.X + r.Width <= X + Width && r.Y + r.Height <= Y + Height;
+			}
+		};
+
+		std::vector<Rect> m_free;
+
+	public:
+		MaxRectsAtlasPacker(uint16_t width, uint16_t height, uint16_t glyphGap)
+			: AtlasPacker(width, height, glyphGap) {
+			if (width > glyphGap && height > glyphGap)
+				m_free.emplace_back(Rect{ 0, 0, width - glyphGap, height - glyphGap });
+		}
+
+		std::optional<Position> Insert(uint16_t width, uint16_t height, uint16_t gap) override {
+			const auto paddedWidth = width + gap;
+			const auto paddedHeight = height + gap + 1;
+
+			// Best short side fit, then best long side fit.
+			const Rect* best = nullptr;
+			auto bestShortSide = INT_MAX, bestLongSide = INT_MAX;
+			for (const auto& r : m_free) {
+				if (r.Width < paddedWidth || r.Height < paddedHeight)
+					continue;
+
+				const auto leftoverX = r.Width - paddedWidth;
+				const auto leftoverY = r.Height - paddedHeight;
+				const auto shortSide = std::min(leftoverX, leftoverY);
+				const auto longSide = std::max(leftoverX, leftoverY);
+				if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+					best = &r;
+					bestShortSide = shortSide;
+					bestLongSide = longSide;
+				}
+			}
+			if (!best)
+				return std::nullopt;
+
+			const auto used = Rect{ best->X, best->Y, paddedWidth, paddedHeight };
+
+			// Free rectangles that do not overlap the used one stay as they are.
+			std::vector<Rect> next;
+			next.reserve(m_free.size() + 4);
+			for (const auto& r : m_free) {
+				if (!r.Intersects(used))
+					next.push_back(r);
+			}
+
+			// Every other free rectangle is replaced with the maximal rectangles left around the used one.
+			const auto keptCount = next.size();
+			for (const auto& r : m_free) {
+				if (!r.Intersects(used))
+					continue;
+				if (used.X > r.X)
+					next.push_back(Rect{ r.X, r.Y, used.X - r.X, r.Height });
+				if (used.X + used.Width < r.X + r.Width)
+					next.push_back(Rect{ used.X + used.Width, r.Y, r.X + r.Width - used.X - used.Width, r.Height });
+				if (used.Y > r.Y)
+					next.push_back(Rect{ r.X, r.Y, r.Width, used.Y - r.Y });
+				if (used.Y + used.Height < r.Y + r.Height)
+					next.push_back(Rect{ r.X, used.Y + used.Height, r.Width, r.Y + r.Height - used.Y - used.Height });
+			}
+
+			// A kept rectangle cannot be contained in a new one, as each new one is a part of a replaced rectangle that was maximal along with it.
+			// Only the new ones need to be checked for being contained in another; of two identical ones, the latter goes.
+			m_free.assign(next.begin(), next.begin() + static_cast<ptrdiff_t>(keptCount));
+			for (auto i = keptCount; i < next.size(); ++i) {
+				auto contained = false;
+				for (size_t j = 0; j < next.size() && !contained; ++j)
+					contained = i != j && next[j].Contains(next[i]) && (j < i || !next[i].Contains(next[j]));
+				if (!contained)
+					m_free.push_back(next[i]);
+			}
+
+			return Position{ static_cast<uint16_t>(used.X + gap), static_cast<uint16_t>(used.Y + gap) };
+		}
+	};
+}
+
+void Sqex::FontCsv::to_json(nlohmann::json& j, const AtlasPackingAlgorithm& o) {
+	switch (o) {
+		case AtlasPackingAlgorithm::Shelf:
+			j = "shelf";
+			break;
+
+		case AtlasPackingAlgorithm::Skyline:
+			j = "skyline";
+			break;
+
+		case AtlasPackingAlgorithm::MaxRects:
+			j = "maxRects";
+			break;
+	}
+}
+
+void Sqex::FontCsv::from_json(const nlohmann::json& j, AtlasPackingAlgorithm& o) {
+	auto s = j.get<std::string>();
+	CharUpperA(&s[0]);
+
+	if (s == "SHELF")
+		o = AtlasPackingAlgorithm::Shelf;
+	else if (s == "SKYLINE")
+		o = AtlasPackingAlgorithm::Skyline;
+	else if (s == "MAXRECTS")
+		o = AtlasPackingAlgorithm::MaxRects;
+	else
+		throw std::invalid_argument(std::format("Unexpected value {} for packing algorithm", j.get<std::string>()));
+}
+
+Sqex::FontCsv::AtlasPacker::AtlasPacker(uint16_t width, uint16_t height, uint16_t glyphGap)
+	: Width(width)
+	, Height(height)
+	, GlyphGap(glyphGap) {
+}
+
+std::unique_ptr<Sqex::FontCsv::AtlasPacker> Sqex::FontCsv::AtlasPacker::New(AtlasPackingAlgorithm algorithm, uint16_t width, uint16_t height, uint16_t glyphGap) {
+	switch (algorithm) {
+		case AtlasPackingAlgorithm::Shelf:
+			return std::make_unique<ShelfAtlasPacker>(width, height, glyphGap);
+
+		case AtlasPackingAlgorithm::Skyline:
+			return std::make_unique<SkylineAtlasPacker>(width, height, glyphGap);
+
+		case AtlasPackingAlgorithm::MaxRects:
+			return std::make_unique<MaxRectsAtlasPacker>(width, height, glyphGap);
+
+		default:
+			throw std::invalid_argument("Unsupported packing algorithm");
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <nlohmann/json.hpp>
+
+namespace Sqex::FontCsv {
+	enum class AtlasPackingAlgorithm {
+		// Fills rows from left to right, and never looks back at a row or a page once it moves on.
+		Shelf,
+
+		// Keeps the top edge of everything placed so far, and puts each glyph where it ends up the lowest.
+		Skyline,
+
+		// Keeps every maximal free rectangle, and puts each glyph into the one it fits the most snugly.
+		MaxRects,
+	};
+	void to_json(nlohmann::json& j, const AtlasPackingAlgorithm& o);
+	void from_json(const nlohmann::json& j, AtlasPackingAlgorithm& o);
+
+	struct AtlasPackingStatistics {
+		size_t PageCount = 0;
+		size_t GlyphCount = 0;
+		uint64_t GlyphArea = 0;
+		uint64_t PageArea = 0;
+		std::chrono::nanoseconds Elapsed{};
+
+		// Fraction of the area of all pages taken up by glyphs, not counting gaps.
+		[[nodiscard]] double Efficiency() const {
+			return PageArea ? static_cast<double>(GlyphArea) / static_cast<double>(PageArea) : 0.;
+		}
+	};
+
+	// Places glyphs onto a single page. Placement depends only on the sequence of calls, so the same input always gives the same layout.
+	class AtlasPacker {
+	public:
+		struct Position {
+			uint16_t X;
+			uint16_t Y;
+		};
+
+		const uint16_t Width;
+		const uint16_t Height;
+		const uint16_t GlyphGap;
+
+		AtlasPacker(uint16_t width, uint16_t height, uint16_t glyphGap);
+		virtual ~AtlasPacker() = default;
+
+		static std::unique_ptr<AtlasPacker> New(AtlasPackingAlgorithm algorithm, uint16_t width, uint16_t height, uint16_t glyphGap);
+
+		// Finds room for a glyph that needs gap pixels of space from everything above and left of it, and at least GlyphGap pixels from everything else.
+		// Returns an empty value if the glyph does not fit in this page.
+		virtual std::optional<Position> Insert(uint16_t width, uint16_t height, uint16_t gap) = 0;
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "XivAlexanderCommon/Sqex/FontCsv/BaseFont.h"
+#include "XivAlexanderCommon/Sqex/FontCsv/BitmapBlend.h"
 #include "XivAlexanderCommon/Sqex/Sqpack.h"
 #include "XivAlexanderCommon/Sqex/Texture.h"
 #include "XivAlexanderCommon/Sqex/Texture/Mipmap.h"
@@ -17,10 +18,43 @@ namespace Sqex::FontCsv {
 
 		static constexpr auto Scaler = 0xFFUL;
 		static constexpr auto MaxOpacity = std::numeric_limits<OpacityType>::max();
+		static constexpr size_t OpacityChunkSize = 256;
+		static constexpr bool UseL8Kernels = std::is_same_v<DestPixFmt, uint8_t> && std::is_same_v<OpacityType, uint8_t>;
+		static constexpr bool UseRgba8888Kernels = std::is_same_v<DestPixFmt, Texture::RGBA8888>;
+
+		using GammaTable = std::array<uint8_t, 256>;
+
+		static inline uint32_t ResolveOpacity(const SrcPixFmt& src, const GammaTable& gammaTable) {
+			return gammaTable[std::min<uint32_t>(ResolverFunction(src), Scaler)];
+		}
+
+		// Calls fn with chunks of the destination line and their opacity after gamma correction, inverted if OpacityIsForeground is false.
+		template<bool OpacityIsForeground = true, typename Fn>
+		static inline void ForEachOpacityChunk(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const GammaTable& gammaTable, const Fn& fn) {
+			uint8_t opacity[OpacityChunkSize];
+			while (regionWidth) {
+				const auto count = std::min(regionWidth, OpacityChunkSize);
+				for (size_t i = 0; i < count; ++i) {
+					const auto opacityScaled = ResolveOpacity(srcPtr[i], gammaTable);
+					opacity[i] = static_cast<uint8_t>(OpacityIsForeground ? opacityScaled : Scaler - opacityScaled);
+				}
+				fn(destPtr, opacity, count);
+				destPtr += count;
+				srcPtr += count;
+				regionWidth -= count;
+			}
+		}
+
+		static inline void DrawLineToRgb(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& fgColor, const DestPixFmt& bgColor, const GammaTable& gammaTable) {
+			if constexpr (UseRgba8888Kernels) {
+				ForEachOpacityChunk(destPtr, srcPtr, regionWidth, gammaTable, [&](DestPixFmt* dest, const uint8_t* opacity, size_t count) {
+					BitmapBlend::BlendRgba8888(dest, opacity, count, fgColor, bgColor);
+				});
+				return;
+			}
 
-		static inline void DrawLineToRgb(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& fgColor, const DestPixFmt& bgColor, double gamma) {
 			while (regionWidth--) {
-				const auto opacityScaled = (uint32_t)(std::pow(1.0 * ResolverFunction(*srcPtr) / Scaler, gamma) * Scaler);
+				const auto opacityScaled = ResolveOpacity(*srcPtr, gammaTable);
 				const auto blendedBgColor = DestPixFmt{
 					(bgColor.R * bgColor.A + destPtr->R * (DestPixFmt::MaxA - bgColor.A)) / DestPixFmt::MaxA,
 					(bgColor.G * bgColor.A + destPtr->G * (DestPixFmt::MaxA - bgColor.A)) / DestPixFmt::MaxA,
@@ -54,9 +88,16 @@ namespace Sqex::FontCsv {
 			}
 		}
 
-		static inline void DrawLineToRgbOpaque(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& fgColor, const DestPixFmt& bgColor, double gamma) {
+		static inline void DrawLineToRgbOpaque(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& fgColor, const DestPixFmt& bgColor, const GammaTable& gammaTable) {
+			if constexpr (UseRgba8888Kernels) {
+				ForEachOpacityChunk(destPtr, srcPtr, regionWidth, gammaTable, [&](DestPixFmt* dest, const uint8_t* opacity, size_t count) {
+					BitmapBlend::BlendRgba8888Opaque(dest, opacity, count, fgColor, bgColor);
+				});
+				return;
+			}
+
 			while (regionWidth--) {
-				const auto opacityScaled = (uint32_t)(std::pow(1.0 * ResolverFunction(*srcPtr) / Scaler, gamma) * Scaler);
+				const auto opacityScaled = ResolveOpacity(*srcPtr, gammaTable);
 				destPtr->R = (bgColor.R * (Scaler - opacityScaled) + fgColor.R * opacityScaled) / Scaler;
 				destPtr->G = (bgColor.G * (Scaler - opacityScaled) + fgColor.G * opacityScaled) / Scaler;
 				destPtr->B = (bgColor.B * (Scaler - opacityScaled) + fgColor.B * opacityScaled) / Scaler;
@@ -67,9 +108,16 @@ namespace Sqex::FontCsv {
 		}
 
 		template<bool ColorIsForeground>
-		static inline void DrawLineToRgbBinaryOpacity(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& color, double gamma) {
+		static inline void DrawLineToRgbBinaryOpacity(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& color, const GammaTable& gammaTable) {
+			if constexpr (UseRgba8888Kernels) {
+				ForEachOpacityChunk<ColorIsForeground>(destPtr, srcPtr, regionWidth, gammaTable, [&](DestPixFmt* dest, const uint8_t* opacity, size_t count) {
+					BitmapBlend::BlendRgba8888Binary(dest, opacity, count, color);
+				});
+				return;
+			}
+
 			while (regionWidth--) {
-				const auto opacityScaled = (uint32_t)(std::pow(1.0 * ResolverFunction(*srcPtr) / Scaler, gamma) * Scaler);
+				const auto opacityScaled = ResolveOpacity(*srcPtr, gammaTable);
 				const auto opacity = DestPixFmt::MaxA * (ColorIsForeground ? opacityScaled : Scaler - opacityScaled) / Scaler;
 				if (opacity) {
 					const auto blendedDestColor = DestPixFmt{
@@ -88,11 +136,18 @@ namespace Sqex::FontCsv {
 			}
 		}
 
-		static inline void DrawLineToL8(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& fgColor, const DestPixFmt& bgColor, OpacityType fgOpacity, OpacityType bgOpacity, double gamma) {
+		static inline void DrawLineToL8(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& fgColor, const DestPixFmt& bgColor, OpacityType fgOpacity, OpacityType bgOpacity, const GammaTable& gammaTable) {
+			if constexpr (UseL8Kernels) {
+				ForEachOpacityChunk(destPtr, srcPtr, regionWidth, gammaTable, [&](DestPixFmt* dest, const uint8_t* opacity, size_t count) {
+					BitmapBlend::BlendL8(dest, opacity, count, fgColor, bgColor, fgOpacity, bgOpacity);
+				});
+				return;
+			}
+
 			constexpr auto DestPixFmtMax = std::numeric_limits<DestPixFmt>::max();
 
 			while (regionWidth--) {
-				const auto opacityScaled = (uint32_t)(std::pow(1.0 * ResolverFunction(*srcPtr) / Scaler, gamma) * Scaler);
+				const auto opacityScaled = ResolveOpacity(*srcPtr, gammaTable);
 				const auto blendedBgColor = (1 * bgColor * bgOpacity + 1 * *destPtr * (MaxOpacity - bgOpacity)) / MaxOpacity;
 				const auto blendedFgColor = (1 * fgColor * fgOpacity + 1 * *destPtr * (MaxOpacity - fgOpacity)) / MaxOpacity;
 				*destPtr = static_cast<DestPixFmt>((blendedBgColor * (Scaler - opacityScaled) + blendedFgColor * opacityScaled) / Scaler);
@@ -101,11 +156,11 @@ namespace Sqex::FontCsv {
 			}
 		}
 
-		static inline void DrawLineToL8Opaque(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, double gamma) {
+		static inline void DrawLineToL8Opaque(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const GammaTable& gammaTable) {
 			constexpr auto DestPixFmtMax = std::numeric_limits<DestPixFmt>::max();
 
 			while (regionWidth--) {
-				const auto opacityScaled = (uint32_t)(std::pow(1.0 * ResolverFunction(*srcPtr) / Scaler, gamma) * Scaler);
+				const auto opacityScaled = ResolveOpacity(*srcPtr, gammaTable);
 				*destPtr = static_cast<DestPixFmt>(MaxOpacity * opacityScaled / Scaler);
 				++destPtr;
 				++srcPtr;
@@ -113,11 +168,18 @@ namespace Sqex::FontCsv {
 		}
 
 		template<bool ColorIsForeground>
-		static inline void DrawLineToL8BinaryOpacity(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& color, double gamma) {
+		static inline void DrawLineToL8BinaryOpacity(DestPixFmt* destPtr, const SrcPixFmt* srcPtr, size_t regionWidth, const DestPixFmt& color, const GammaTable& gammaTable) {
+			if constexpr (UseL8Kernels) {
+				ForEachOpacityChunk<ColorIsForeground>(destPtr, srcPtr, regionWidth, gammaTable, [&](DestPixFmt* dest, const uint8_t* opacity, size_t count) {
+					BitmapBlend::BlendL8Binary(dest, opacity, count, color);
+				});
+				return;
+			}
+
 			constexpr auto DestPixFmtMax = std::numeric_limits<DestPixFmt>::max();
 
 			while (regionWidth--) {
-				const auto opacityScaled = (uint32_t)(std::pow(1.0 * ResolverFunction(*srcPtr) / Scaler, gamma) * Scaler);
+				const auto opacityScaled = ResolveOpacity(*srcPtr, gammaTable);
 				const auto opacityScaled2 = ColorIsForeground ? opacityScaled : Scaler - opacityScaled;
 				*destPtr = static_cast<DestPixFmt>((*destPtr * (Scaler - opacityScaled2) + 1 * color * opacityScaled2) / Scaler);
 				++destPtr;
@@ -133,39 +195,39 @@ namespace Sqex::FontCsv {
 			const auto regionWidth = src.right - src.left;
 			const auto regionHeight = src.bottom - src.top;
 
-			gamma = 1.0 / gamma;
+			const auto& gammaTable = BitmapBlend::GammaTable(1.0 / gamma);
 
 			if constexpr (std::is_integral_v<DestPixFmt>) {
 				constexpr auto DestPixFmtMax = std::numeric_limits<DestPixFmt>::max();
 
 				if (fgOpacity == MaxOpacity && bgOpacity == MaxOpacity && fgColor == DestPixFmtMax && bgColor == 0) {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToL8Opaque(destPtrBegin, srcPtrBegin, regionWidth, gamma);
+						DrawLineToL8Opaque(destPtrBegin, srcPtrBegin, regionWidth, gammaTable);
 				} else if (fgOpacity == MaxOpacity && bgOpacity == 0) {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToL8BinaryOpacity<true>(destPtrBegin, srcPtrBegin, regionWidth, fgColor, gamma);
+						DrawLineToL8BinaryOpacity<true>(destPtrBegin, srcPtrBegin, regionWidth, fgColor, gammaTable);
 				} else if (fgOpacity == 0 && bgOpacity == MaxOpacity) {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToL8BinaryOpacity<false>(destPtrBegin, srcPtrBegin, regionWidth, bgColor, gamma);
+						DrawLineToL8BinaryOpacity<false>(destPtrBegin, srcPtrBegin, regionWidth, bgColor, gammaTable);
 				} else {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToL8(destPtrBegin, srcPtrBegin, regionWidth, fgColor, bgColor, fgOpacity, bgOpacity, gamma);
+						DrawLineToL8(destPtrBegin, srcPtrBegin, regionWidth, fgColor, bgColor, fgOpacity, bgOpacity, gammaTable);
 				}
 			} else {
 				fgColor.A = fgColor.A * fgOpacity / std::numeric_limits<OpacityType>::max();
 				bgColor.A = bgColor.A * bgOpacity / std::numeric_limits<OpacityType>::max();
 				if (fgColor.A == DestPixFmt::MaxA && bgColor.A == DestPixFmt::MaxA) {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToRgbOpaque(destPtrBegin, srcPtrBegin, regionWidth, fgColor, bgColor, gamma);
+						DrawLineToRgbOpaque(destPtrBegin, srcPtrBegin, regionWidth, fgColor, bgColor, gammaTable);
 				} else if (fgColor.A == DestPixFmt::MaxA && bgColor.A == 0) {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToRgbBinaryOpacity<true>(destPtrBegin, srcPtrBegin, regionWidth, fgColor, gamma);
+						DrawLineToRgbBinaryOpacity<true>(destPtrBegin, srcPtrBegin, regionWidth, fgColor, gammaTable);
 				} else if (fgColor.A == 0 && bgColor.A == DestPixFmt::MaxA) {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToRgbBinaryOpacity<false>(destPtrBegin, srcPtrBegin, regionWidth, bgColor, gamma);
+						DrawLineToRgbBinaryOpacity<false>(destPtrBegin, srcPtrBegin, regionWidth, bgColor, gammaTable);
 				} else {
 					for (auto i = 0; i < regionHeight; ++i, destPtrBegin += destWidth, srcPtrBegin += srcPtrDelta)
-						DrawLineToRgb(destPtrBegin, srcPtrBegin, regionWidth, fgColor, bgColor, gamma);
+						DrawLineToRgb(destPtrBegin, srcPtrBegin, regionWidth, fgColor, bgColor, gammaTable);
 				}
 			}
 		}
@@ -0,0 +1,227 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/FontCsv/BitmapBlend.h"
+
+#include <emmintrin.h>
+#include <mutex>
+
+// All values fit in 16-bit lanes: every product is of two values in [0, 255], and every sum is of the form a * b + c * (255 - b).
+
+// Exact x / 255 for x in [0, 65535).
+static __m128i Div255(__m128i x) {
+	return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+// 255 - x.
+static __m128i Inv(__m128i x) {
+	return _mm_xor_si128(x, _mm_set1_epi16(0xFF));
+}
+
+// (a * (255 - w) + b * w) / 255.
+static __m128i Lerp(__m128i a, __m128i b, __m128i w) {
+	return Div255(_mm_add_epi16(_mm_mullo_epi16(a, Inv(w)), _mm_mullo_epi16(b, w)));
+}
+
+// Copies the opacity of each of the two pixels in x into all four of its channels.
+static __m128i BroadcastAlpha(__m128i x) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static __m128i Select(__m128i mask, __m128i ifSet, __m128i ifUnset) {
+	return _mm_or_si128(_mm_and_si128(mask, ifSet), _mm_andnot_si128(mask, ifUnset));
+}
+
+// Expands 4 opacity values to 16 bytes, each repeated for the four channels of a pixel.
+static __m128i LoadOpacity4(const uint8_t* opacity) {
+	uint32_t packed;
+	std::memcpy(&packed, opacity, sizeof packed);
+	const auto v = _mm_cvtsi32_si128(static_cast<int>(packed));
+	const auto v2 = _mm_unpacklo_epi8(v, v);
+	return _mm_unpacklo_epi16(v2, v2);
+}
+
+// Composites over onto under: colors are lerped by overA, and opacity becomes 255 - (255 - underA) * (255 - overA) / 255.
+static __m128i CompositeAlpha(__m128i alphaMask, __m128i under, __m128i underA, __m128i over, __m128i overA) {
+	const auto color = Lerp(under, over, overA);
+	const auto alpha = Inv(Div255(_mm_mullo_epi16(Inv(underA), Inv(overA))));
+	return Select(alphaMask, alpha, color);
+}
+
+const std::array<uint8_t, 256>& Sqex::FontCsv::BitmapBlend::GammaTable(double exponent) {
+	thread_local double s_lastExponent;
+	thread_local const std::array<uint8_t, 256>* s_lastTable = nullptr;
+	if (s_lastTable && s_lastExponent == exponent)
+		return *s_lastTable;
+
+	static std::mutex s_mtx;
+	static std::map<double, std::array<uint8_t, 256>> s_tables;
+
+	const auto lock = std::lock_guard(s_mtx);
+	const auto [it, inserted] = s_tables.try_emplace(exponent);
+	if (inserted) {
+		for (size_t i = 0; i < it->second.size(); ++i)
+			it->second[i] = static_cast<uint8_t>(static_cast<uint32_t>(std::pow(1.0 * i / 255, exponent) * 255));
+	}
+	s_lastExponent = exponent;
+	s_lastTable = &it->second;
+	return it->second;
+}
+
+void Sqex::FontCsv::BitmapBlend::BlendL8(uint8_t* dest, const uint8_t* opacity, size_t count, uint8_t fgColor, uint8_t bgColor, uint8_t fgOpacity, uint8_t bgOpacity) {
+	const auto zero = _mm_setzero_si128();
+	const auto fg = _mm_set1_epi16(fgColor);
+	const auto bg = _mm_set1_epi16(bgColor);
+	const auto fgO = _mm_set1_epi16(fgOpacity);
+	const auto bgO = _mm_set1_epi16(bgOpacity);
+
+	for (; count >= 16; count -= 16, dest += 16, opacity += 16) {
+		const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+		const auto o = _mm_loadu_si128(reinterpret_cast<const __m128i*>(opacity));
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const auto d16 = half ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+			const auto o16 = half ? _mm_unpackhi_epi8(o, zero) : _mm_unpacklo_epi8(o, zero);
+			res[half] = Lerp(Lerp(d16, bg, bgO), Lerp(d16, fg, fgO), o16);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(res[0], res[1]));
+	}
+
+	for (; count; --count, ++dest, ++opacity) {
+		const auto blendedBgColor = (1 * bgColor * bgOpacity + 1 * *dest * (255 - bgOpacity)) / 255;
+		const auto blendedFgColor = (1 * fgColor * fgOpacity + 1 * *dest * (255 - fgOpacity)) / 255;
+		*dest = static_cast<uint8_t>((blendedBgColor * (255 - *opacity) + blendedFgColor * *opacity) / 255);
+	}
+}
+
+void Sqex::FontCsv::BitmapBlend::BlendL8Binary(uint8_t* dest, const uint8_t* opacity, size_t count, uint8_t color) {
+	const auto zero = _mm_setzero_si128();
+	const auto c = _mm_set1_epi16(color);
+
+	for (; count >= 16; count -= 16, dest += 16, opacity += 16) {
+		const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+		const auto o = _mm_loadu_si128(reinterpret_cast<const __m128i*>(opacity));
+		const auto lo = Lerp(_mm_unpacklo_epi8(d, zero), c, _mm_unpacklo_epi8(o, zero));
+		const auto hi = Lerp(_mm_unpackhi_epi8(d, zero), c, _mm_unpackhi_epi8(o, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(lo, hi));
+	}
+
+	for (; count; --count, ++dest, ++opacity)
+		*dest = static_cast<uint8_t>((*dest * (255 - *opacity) + 1 * color * *opacity) / 255);
+}
+
+void Sqex::FontCsv::BitmapBlend::BlendRgba8888Opaque(Texture::RGBA8888* dest, const uint8_t* opacity, size_t count, Texture::RGBA8888 fgColor, Texture::RGBA8888 bgColor) {
+	const auto zero = _mm_setzero_si128();
+	const auto fg = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(fgColor.Value)), zero);
+	const auto bg = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(bgColor.Value)), zero);
+	const auto alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+
+	for (; count >= 4; count -= 4, dest += 4, opacity += 4) {
+		const auto o = LoadOpacity4(opacity);
+		const auto lo = Lerp(bg, fg, _mm_unpacklo_epi8(o, zero));
+		const auto hi = Lerp(bg, fg, _mm_unpackhi_epi8(o, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_or_si128(_mm_packus_epi16(lo, hi), alpha));
+	}
+
+	for (; count; --count, ++dest, ++opacity) {
+		const uint32_t o = *opacity;
+		dest->R = (bgColor.R * (255U - o) + fgColor.R * o) / 255U;
+		dest->G = (bgColor.G * (255U - o) + fgColor.G * o) / 255U;
+		dest->B = (bgColor.B * (255U - o) + fgColor.B * o) / 255U;
+		dest->A = 255U;
+	}
+}
+
+void Sqex::FontCsv::BitmapBlend::BlendRgba8888Binary(Texture::RGBA8888* dest, const uint8_t* opacity, size_t count, Texture::RGBA8888 color) {
+	const auto zero = _mm_setzero_si128();
+	const auto alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+	const auto c = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color.Value)), zero);
+
+	for (; count >= 4; count -= 4, dest += 4, opacity += 4) {
+		const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+		const auto o = LoadOpacity4(opacity);
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const auto d16 = half ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+			const auto o16 = half ? _mm_unpackhi_epi8(o, zero) : _mm_unpacklo_epi8(o, zero);
+			const auto dA = BroadcastAlpha(d16);
+			const auto blendedDest = CompositeAlpha(alphaMask, c, o16, d16, dA);
+			const auto blended = Select(alphaMask, blendedDest, Lerp(blendedDest, c, o16));
+			res[half] = Select(_mm_cmpeq_epi16(o16, zero), d16, blended);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(res[0], res[1]));
+	}
+
+	for (; count; --count, ++dest, ++opacity) {
+		const uint32_t o = *opacity;
+		if (!o)
+			continue;
+		const auto blendedDestColor = Texture::RGBA8888{
+			(dest->R * dest->A + color.R * (255U - dest->A)) / 255U,
+			(dest->G * dest->A + color.G * (255U - dest->A)) / 255U,
+			(dest->B * dest->A + color.B * (255U - dest->A)) / 255U,
+			255U - ((255U - dest->A) * (255U - o)) / 255U,
+		};
+		dest->R = (blendedDestColor.R * (255U - o) + color.R * o) / 255U;
+		dest->G = (blendedDestColor.G * (255U - o) + color.G * o) / 255U;
+		dest->B = (blendedDestColor.B * (255U - o) + color.B * o) / 255U;
+		dest->A = blendedDestColor.A;
+	}
+}
+
+void Sqex::FontCsv::BitmapBlend::BlendRgba8888(Texture::RGBA8888* dest, const uint8_t* opacity, size_t count, Texture::RGBA8888 fgColor, Texture::RGBA8888 bgColor) {
+	const auto zero = _mm_setzero_si128();
+	const auto alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+	const auto fg = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(fgColor.Value)), zero);
+	const auto bg = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(bgColor.Value)), zero);
+	const auto fgA = BroadcastAlpha(fg);
+	const auto bgA = BroadcastAlpha(bg);
+
+	for (; count >= 4; count -= 4, dest += 4, opacity += 4) {
+		const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dest));
+		const auto o = LoadOpacity4(opacity);
+		__m128i res[2];
+		for (int half = 0; half < 2; ++half) {
+			const auto d16 = half ? _mm_unpackhi_epi8(d, zero) : _mm_unpacklo_epi8(d, zero);
+			const auto o16 = half ? _mm_unpackhi_epi8(o, zero) : _mm_unpacklo_epi8(o, zero);
+			const auto dA = BroadcastAlpha(d16);
+			const auto blendedBg = CompositeAlpha(alphaMask, d16, dA, bg, bgA);
+			const auto blendedFg = CompositeAlpha(alphaMask, d16, dA, fg, fgA);
+			const auto current = Lerp(blendedBg, blendedFg, o16);
+			const auto currentA = BroadcastAlpha(current);
+			const auto blendedDest = CompositeAlpha(alphaMask, current, currentA, d16, dA);
+			res[half] = Select(alphaMask, blendedDest, Lerp(blendedDest, current, currentA));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(res[0], res[1]));
+	}
+
+	for (; count; --count, ++dest, ++opacity) {
+		const uint32_t o = *opacity;
+		const auto blendedBgColor = Texture::RGBA8888{
+			(bgColor.R * bgColor.A + dest->R * (255U - bgColor.A)) / 255U,
+			(bgColor.G * bgColor.A + dest->G * (255U - bgColor.A)) / 255U,
+			(bgColor.B * bgColor.A + dest->B * (255U - bgColor.A)) / 255U,
+			255U - ((255U - bgColor.A) * (255U - dest->A)) / 255U,
+		};
+		const auto blendedFgColor = Texture::RGBA8888{
+			(fgColor.R * fgColor.A + dest->R * (255U - fgColor.A)) / 255U,
+			(fgColor.G * fgColor.A + dest->G * (255U - fgColor.A)) / 255U,
+			(fgColor.B * fgColor.A + dest->B * (255U - fgColor.A)) / 255U,
+			255U - ((255U - fgColor.A) * (255U - dest->A)) / 255U,
+		};
+		const auto currentColor = Texture::RGBA8888{
+			(blendedBgColor.R * (255U - o) + blendedFgColor.R * o) / 255U,
+			(blendedBgColor.G * (255U - o) + blendedFgColor.G * o) / 255U,
+			(blendedBgColor.B * (255U - o) + blendedFgColor.B * o) / 255U,
+			(blendedBgColor.A * (255U - o) + blendedFgColor.A * o) / 255U,
+		};
+		const auto blendedDestColor = Texture::RGBA8888{
+			(dest->R * dest->A + currentColor.R * (255U - dest->A)) / 255U,
+			(dest->G * dest->A + currentColor.G * (255U - dest->A)) / 255U,
+			(dest->B * dest->A + currentColor.B * (255U - dest->A)) / 255U,
+			255U - ((255U - dest->A) * (255U - currentColor.A)) / 255U,
+		};
+		dest->R = (blendedDestColor.R * (255U - currentColor.A) + currentColor.R * currentColor.A) / 255U;
+		dest->G = (blendedDestColor.G * (255U - currentColor.A) + currentColor.G * currentColor.A) / 255U;
+		dest->B = (blendedDestColor.B * (255U - currentColor.A) + currentColor.B * currentColor.A) / 255U;
+		dest->A = blendedDestColor.A;
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+
+#include "XivAlexanderCommon/Sqex/Texture.h"
+
+// Blending kernels behind RgbBitmapCopy. Each takes a row of opacity values that already went through GammaTable,
+// and produces exactly what the scalar code in RgbBitmapCopy would for the same destination and source pixels.
+namespace Sqex::FontCsv::BitmapBlend {
+	// Maps opacity in [0, 255] to pow(opacity / 255, exponent) * 255, truncated. Tables are built once per exponent and kept.
+	const std::array<uint8_t, 256>& GammaTable(double exponent);
+
+	// Blends fgColor and bgColor, each weighed by its own opacity against the destination, by opacity.
+	void BlendL8(uint8_t* dest, const uint8_t* opacity, size_t count, uint8_t fgColor, uint8_t bgColor, uint8_t fgOpacity, uint8_t bgOpacity);
+
+	// Blends color into the destination by opacity.
+	void BlendL8Binary(uint8_t* dest, const uint8_t* opacity, size_t count, uint8_t color);
+
+	// Blends fgColor and bgColor, both of which should be opaque, by opacity, ignoring the destination.
+	void BlendRgba8888Opaque(Texture::RGBA8888* dest, const uint8_t* opacity, size_t count, Texture::RGBA8888 fgColor, Texture::RGBA8888 bgColor);
+
+	// Composites color under the destination, then over it by opacity; pixels with no opacity are left untouched.
+	void BlendRgba8888Binary(Texture::RGBA8888* dest, const uint8_t* opacity, size_t count, Texture::RGBA8888 color);
+
+	// Composites fgColor and bgColor over the destination, blends the two by opacity, and then composites the result with the destination.
+	void BlendRgba8888(Texture::RGBA8888* dest, const uint8_t* opacity, size_t count, Texture::RGBA8888 fgColor, Texture::RGBA8888 bgColor);
+}
@@ -526,6 +526,7 @@ void Sqex::FontCsv::CreateConfig::to_json(nlohmann::json& j, const FontCreateCon
 	j = nlohmann::json::object({
 		{"glyphGap", o.glyphGap},
 		{"compactLayout", o.compactLayout},
+		{"packing", o.packing},
 		{"textureWidth", o.textureWidth},
 		{"textureHeight", o.textureHeight},
 		{"textureFormat", o.textureFormat},
@@ -553,6 +554,7 @@ void Sqex::FontCsv::CreateConfig::from_json(const nlohmann::json& j, FontCreateC
 	try {
 		o.glyphGap = j.value<uint16_t>(lastAttempt = "glyphGap", 1);
 		o.compactLayout = j.value(lastAttempt = "compactLayout", false);
+		o.packing = j.value(lastAttempt = "packing", AtlasPackingAlgorithm::Shelf);
 		o.textureWidth = j.value<uint16_t>(lastAttempt = "textureWidth", 1024);
 		o.textureHeight = j.value<uint16_t>(lastAttempt = "textureHeight", 1024);
 		o.textureFormat = Texture::Format::A4R4G4B4;
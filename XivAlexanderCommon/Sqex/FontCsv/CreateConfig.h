@@ -7,6 +7,7 @@
 #include <vector>
 #include <nlohmann/json.hpp>
 
+#include "XivAlexanderCommon/Sqex/FontCsv/AtlasPacker.h"
 #include "XivAlexanderCommon/Sqex/Texture.h"
 
 namespace Sqex::FontCsv::CreateConfig {
@@ -161,6 +162,7 @@ namespace Sqex::FontCsv::CreateConfig {
 	struct FontCreateConfig {
 		uint16_t glyphGap{};
 		bool compactLayout{};
+		AtlasPackingAlgorithm packing{};
 		uint16_t textureWidth{};
 		uint16_t textureHeight{};
 		Texture::Format textureFormat{};
@@ -203,9 +203,10 @@ struct Sqex::FontCsv::FontCsvCreator::RenderTarget::Implementation {
 	const uint16_t TextureWidth;
 	const uint16_t TextureHeight;
 	const uint16_t GlyphGap;
-	uint16_t CurrentX;
-	uint16_t CurrentY;
-	uint16_t CurrentLineHeight;
+	const AtlasPackingAlgorithm Packing;
+
+	std::vector<std::unique_ptr<AtlasPacker>> Packers;
+	AtlasPackingStatistics Statistics;
 
 	std::vector<std::shared_ptr<Texture::MemoryBackedMipmap>> Mipmaps;
 	std::map<std::tuple<char32_t, const BaseDrawableFont<uint8_t>*, uint8_t, uint8_t, uint8_t, uint8_t>, AllocatedSpace> DrawnGlyphs;
@@ -238,39 +239,37 @@ struct Sqex::FontCsv::FontCsvCreator::RenderTarget::Implementation {
 
 		const auto [it, isNewEntry] = DrawnGlyphs.emplace(std::make_tuple(c, font, borderThickness, borderOpacity, boundingWidth, boundingHeight), AllocatedSpace{});
 		if (isNewEntry) {
-			auto newTargetRequired = false;
-			if (Mipmaps.empty())
-				newTargetRequired = true;
-			else {
-				if (static_cast<size_t>(0) + CurrentX + boundingWidth + actualGlyphGap >= TextureWidth) {
-					CurrentX = actualGlyphGap;
-					CurrentY += CurrentLineHeight + actualGlyphGap + 1;  // Account for rounding errors
-					CurrentLineHeight = 0;
-				}
-				if (CurrentY + boundingHeight + actualGlyphGap + 1 >= TextureHeight)
-					newTargetRequired = true;
+			const auto begin = std::chrono::steady_clock::now();
+
+			std::optional<AtlasPacker::Position> position;
+			size_t index = 0;
+			for (; index < Packers.size(); ++index) {
+				if ((position = Packers[index]->Insert(boundingWidth, boundingHeight, actualGlyphGap)))
+					break;
 			}
 
-			if (newTargetRequired) {
+			if (!position) {
+				Packers.emplace_back(AtlasPacker::New(Packing, TextureWidth, TextureHeight, GlyphGap));
 				Mipmaps.emplace_back(std::make_shared<Texture::MemoryBackedMipmap>(TextureWidth, TextureHeight, 1, Texture::Format::L8));
-				CurrentX = CurrentY = GlyphGap;
-				CurrentLineHeight = 0;
+				position = Packers.back()->Insert(boundingWidth, boundingHeight, actualGlyphGap);
+				if (!position) {
+					DrawnGlyphs.erase(it);
+					throw std::invalid_argument("glyph does not fit in a texture");
+				}
 			}
 
-			if (CurrentX < actualGlyphGap)
-				CurrentX = actualGlyphGap;
-			if (CurrentY < actualGlyphGap)
-				CurrentY = actualGlyphGap;
-
 			it->second = AllocatedSpace{
-				.Index = static_cast<uint16_t>(Mipmaps.size() - 1),
-				.X = CurrentX,
-				.Y = CurrentY,
+				.Index = static_cast<uint16_t>(index),
+				.X = position->X,
+				.Y = position->Y,
 				.BoundingHeight = boundingHeight,
 			};
 
-			CurrentX += boundingWidth + GlyphGap;
-			CurrentLineHeight = std::max<uint16_t>(CurrentLineHeight, boundingHeight);
+			Statistics.PageCount = Packers.size();
+			Statistics.GlyphCount++;
+			Statistics.GlyphArea += static_cast<uint64_t>(boundingWidth) * boundingHeight;
+			Statistics.PageArea = static_cast<uint64_t>(TextureWidth) * TextureHeight * Packers.size();
+			Statistics.Elapsed += std::chrono::steady_clock::now() - begin;
 		}
 
 		return std::make_pair(it->second, isNewEntry);
@@ -301,8 +300,8 @@ struct Sqex::FontCsv::FontCsvCreator::RenderTarget::Implementation {
 	}
 };
 
-Sqex::FontCsv::FontCsvCreator::RenderTarget::RenderTarget(uint16_t textureWidth, uint16_t textureHeight, uint16_t glyphGap)
-	: m_pImpl(std::make_unique<Implementation>(textureWidth, textureHeight, glyphGap, glyphGap, glyphGap, 0)) {
+Sqex::FontCsv::FontCsvCreator::RenderTarget::RenderTarget(uint16_t textureWidth, uint16_t textureHeight, uint16_t glyphGap, AtlasPackingAlgorithm packing)
+	: m_pImpl(std::make_unique<Implementation>(textureWidth, textureHeight, glyphGap, packing)) {
 }
 
 Sqex::FontCsv::FontCsvCreator::RenderTarget::~RenderTarget() = default;
@@ -444,6 +443,10 @@ uint16_t Sqex::FontCsv::FontCsvCreator::RenderTarget::TextureHeight() const {
 	return m_pImpl->TextureHeight;
 }
 
+Sqex::FontCsv::AtlasPackingStatistics Sqex::FontCsv::FontCsvCreator::RenderTarget::GetPackingStatistics() const {
+	return m_pImpl->Statistics;
+}
+
 void Sqex::FontCsv::FontCsvCreator::Step2_Layout(RenderTarget& renderTarget) {
 	try {
 		const auto borderThickness = static_cast<uint8_t>(this->BorderOpacity ? this->BorderThickness : 0);
@@ -600,6 +603,7 @@ struct Sqex::FontCsv::FontSetsCreator::Implementation {
 	std::map<std::tuple<std::filesystem::path, std::filesystem::path>, std::vector<std::shared_ptr<const Texture::MipmapStream>>> GameTextures;
 	std::map<std::string, std::shared_ptr<const BaseDrawableFont<uint8_t>>> SourceFonts;
 	std::map<std::string, std::filesystem::path> ResolvedGameIndexFiles;
+	std::shared_ptr<FreeTypeGlyphCache> GlyphCache;
 
 	ResultFontSets Result;
 	std::mutex ResultMtx;
@@ -755,13 +759,14 @@ struct Sqex::FontCsv::FontSetsCreator::Implementation {
 
 			} else if (inputFontSource.freeTypeSource) {
 				const auto& source = *inputFontSource.freeTypeSource;
+				std::shared_ptr<FreeTypeDrawingFont<uint8_t>> ffont;
 				if (source.fontFile.empty() && source.familyName.empty())
 					throw std::invalid_argument("Neither of fontFile nor familyName was specified.");
 
 				std::string accumulatedError;
 				if (!source.fontFile.empty()) {
 					try {
-						newFont = std::make_shared<FreeTypeDrawingFont<uint8_t>>(
+						ffont = std::make_shared<FreeTypeDrawingFont<uint8_t>>(
 							source.fontFile, source.faceIndex, static_cast<float>(source.height * source.oversampleScale), source.loadFlags
 						);
 					} catch (const std::exception& e) {
@@ -771,9 +776,9 @@ struct Sqex::FontCsv::FontSetsCreator::Implementation {
 					}
 				}
 
-				if (!newFont && !source.familyName.empty()) {
+				if (!ffont && !source.familyName.empty()) {
 					try {
-						newFont = std::make_shared<FreeTypeDrawingFont<uint8_t>>(
+						ffont = std::make_shared<FreeTypeDrawingFont<uint8_t>>(
 							FromUtf8(source.familyName).c_str(), static_cast<float>(source.height * source.oversampleScale), static_cast<DWRITE_FONT_WEIGHT>(source.weight), source.stretch, source.style, source.loadFlags
 						);
 					} catch (const std::exception& e) {
@@ -783,9 +788,12 @@ struct Sqex::FontCsv::FontSetsCreator::Implementation {
 					}
 				}
 
-				if (!newFont)
+				if (!ffont)
 					throw std::invalid_argument(accumulatedError);
 
+				if (GlyphCache)
+					ffont->UseGlyphCache(GlyphCache);
+				newFont = std::move(ffont);
 				newFont->Base.AdvanceWidthDelta(source.advanceWidthDelta* source.oversampleScale);
 				newFont->Gamma(source.gamma);
 
@@ -811,7 +819,7 @@ struct Sqex::FontCsv::FontSetsCreator::Implementation {
 		for (const auto& target : Config.targets) {
 			const auto& textureGroupFilenamePattern = target.first;
 			const auto& fonts = target.second;
-			renderTargets.emplace(textureGroupFilenamePattern, std::make_unique<FontCsvCreator::RenderTarget>(Config.textureWidth, Config.textureHeight, Config.glyphGap));
+			renderTargets.emplace(textureGroupFilenamePattern, std::make_unique<FontCsvCreator::RenderTarget>(Config.textureWidth, Config.textureHeight, Config.glyphGap, Config.packing));
 			TextureGroupWorkPools.emplace(textureGroupFilenamePattern, std::make_unique<Win32::TpEnvironment>(L"FontCsvCreator::Implementation::TextureGroupWorkPools"));
 			Result.Result.emplace(textureGroupFilenamePattern, ResultFontSet{});
 			auto& remainingFonts = ResultWork.emplace(textureGroupFilenamePattern, std::map<std::string, std::unique_ptr<FontCsvCreator>>()).first->second;
@@ -947,6 +955,7 @@ struct Sqex::FontCsv::FontSetsCreator::Implementation {
 
 						remainingFonts.at(fontName)->Step2_Layout(target);
 					}
+					resultSet.PackingStatistics = target.GetPackingStatistics();
 
 					// Step 3. Draw glyphs onto mipmaps.
 					for (const auto& fontName : sortedRemainingFontList) {
@@ -1047,6 +1056,10 @@ void Sqex::FontCsv::FontSetsCreator::ProvideGameDirectory(Sqex::GameReleaseRegio
 	m_pImpl->GameRootDirectories.emplace(region, std::move(path));
 }
 
+void Sqex::FontCsv::FontSetsCreator::UseGlyphCache(std::shared_ptr<FreeTypeGlyphCache> cache) {
+	m_pImpl->GlyphCache = std::move(cache);
+}
+
 void Sqex::FontCsv::FontSetsCreator::VerifyRequirements(
 	const std::function<std::filesystem::path(const CreateConfig::GameIndexFile&)>& promptGameIndexFile,
 	const std::function<bool(const CreateConfig::FontRequirement&)>& promptFontRequirement
@@ -3,8 +3,10 @@
 #include <memory>
 #include <set>
 
+#include "XivAlexanderCommon/Sqex/FontCsv/AtlasPacker.h"
 #include "XivAlexanderCommon/Sqex/FontCsv/CreateConfig.h"
 #include "XivAlexanderCommon/Sqex/FontCsv/BaseDrawableFont.h"
+#include "XivAlexanderCommon/Sqex/FontCsv/FreeTypeGlyphCache.h"
 #include "XivAlexanderCommon/Sqex/Texture/Mipmap.h"
 #include "XivAlexanderCommon/Sqex/Texture/ModifiableTextureStream.h"
 #include "XivAlexanderCommon/Utils/ListenerManager.h"
@@ -69,7 +71,7 @@ namespace Sqex::FontCsv {
 			const std::unique_ptr<Implementation> m_pImpl;
 
 		public:
-			RenderTarget(uint16_t textureWidth, uint16_t textureHeight, uint16_t glyphGap);
+			RenderTarget(uint16_t textureWidth, uint16_t textureHeight, uint16_t glyphGap, AtlasPackingAlgorithm packing = AtlasPackingAlgorithm::Shelf);
 			~RenderTarget();
 
 			void Finalize(Texture::Format textureFormat = Texture::Format::A4R4G4B4);
@@ -79,6 +81,7 @@ namespace Sqex::FontCsv {
 
 			[[nodiscard]] uint16_t TextureWidth() const;
 			[[nodiscard]] uint16_t TextureHeight() const;
+			[[nodiscard]] AtlasPackingStatistics GetPackingStatistics() const;
 
 		protected:
 			struct AllocatedSpace {
@@ -113,6 +116,7 @@ namespace Sqex::FontCsv {
 		struct ResultFontSet {
 			std::map<std::string, std::shared_ptr<ModifiableFontCsvStream>> Fonts;
 			std::vector<std::shared_ptr<Texture::ModifiableTextureStream>> Textures;
+			AtlasPackingStatistics PackingStatistics;
 		};
 
 		struct ResultFontSets {
@@ -122,6 +126,7 @@ namespace Sqex::FontCsv {
 		};
 		
 		void ProvideGameDirectory(Sqex::GameReleaseRegion, std::filesystem::path);
+		void UseGlyphCache(std::shared_ptr<FreeTypeGlyphCache> cache);
 		void VerifyRequirements(
 			const std::function<std::filesystem::path(const CreateConfig::GameIndexFile&)>& promptGameIndexFile,
 			const std::function<bool(const CreateConfig::FontRequirement&)>& promptFontRequirement
@@ -7,6 +7,7 @@ struct Sqex::FontCsv::FreeTypeFont::Implementation {
 	class LibraryAccessor;
 
 	FreeTypeFont* const this_;
+	const std::filesystem::path Path;
 	const Win32::Handle File;
 	const Win32::FileMapping FileMapping;
 	const Win32::FileMapping::View FileMappingView;
@@ -42,8 +43,12 @@ public:
 	const std::vector<char32_t> CharacterList;
 	const std::map<std::pair<char32_t, char32_t>, SSIZE_T> KerningMap;
 
+	std::shared_ptr<FreeTypeGlyphCache> GlyphCache;
+	std::string GlyphCacheFaceKey;
+
 	Implementation(FreeTypeFont* this_, const std::filesystem::path& path, int faceIndex, float size)
 		: this_(this_)
+		, Path(path)
 		, File(Win32::Handle::FromCreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0))
 		, FileMapping(Win32::FileMapping::Create(File))
 		, FileMappingView(Win32::FileMapping::View::Create(FileMapping))
@@ -133,6 +138,11 @@ Sqex::FontCsv::FreeTypeFont::~FreeTypeFont() {
 	}
 }
 
+void Sqex::FontCsv::FreeTypeFont::UseGlyphCache(std::shared_ptr<FreeTypeGlyphCache> cache) {
+	m_pImpl->GlyphCacheFaceKey = cache ? cache->MakeFaceKey(m_pImpl->GetLibraryUnprotected(), m_pImpl->Path, m_pImpl->FileMappingView.AsSpan<uint8_t>(), m_pImpl->FaceIndex, m_pImpl->Size) : std::string();
+	m_pImpl->GlyphCache = std::move(cache);
+}
+
 bool Sqex::FontCsv::FreeTypeFont::HasCharacter(char32_t c) const {
 	return FT_Get_Char_Index(*GetFace(), c);
 }
@@ -158,6 +168,8 @@ const std::map<std::pair<char32_t, char32_t>, SSIZE_T>& Sqex::FontCsv::FreeTypeF
 }
 
 Sqex::FontCsv::GlyphMeasurement Sqex::FontCsv::FreeTypeFont::Measure(SSIZE_T x, SSIZE_T y, char32_t c) const {
+	if (const auto glyph = GetCachedGlyph(c))
+		return ToMeasurement(*glyph, x, y);
 	return GetFace(c).ToMeasurement(x, y);
 }
 
@@ -202,3 +214,63 @@ Sqex::FontCsv::FreeTypeFont::FtFaceCtxMgr Sqex::FontCsv::FreeTypeFont::GetFace(c
 		Succ(FT_Load_Char(*face, c, m_loadFlags | additionalFlags));
 	return face;
 }
+
+std::shared_ptr<const Sqex::FontCsv::FreeTypeGlyphCache::Glyph> Sqex::FontCsv::FreeTypeFont::GetCachedGlyph(char32_t c, FT_Int32 additionalFlags) const {
+	const auto& cache = m_pImpl->GlyphCache;
+	if (!cache)
+		return nullptr;
+
+	const auto loadFlags = m_loadFlags | additionalFlags;
+	if (auto glyph = cache->Find(m_pImpl->GlyphCacheFaceKey, c, loadFlags))
+		return glyph;
+
+	const auto face = GetFace(c, additionalFlags);
+	const auto& slot = *face->glyph;
+	auto glyph = std::make_shared<FreeTypeGlyphCache::Glyph>(FreeTypeGlyphCache::Glyph{
+		.Missing = slot.glyph_index == 0,
+		.BitmapLeft = slot.bitmap_left,
+		.BitmapTop = slot.bitmap_top,
+		.Width = slot.bitmap.width,
+		.Rows = slot.bitmap.rows,
+		.AdvanceX = static_cast<int32_t>(slot.advance.x),
+		.NumGrays = static_cast<uint16_t>(slot.bitmap.num_grays),
+	});
+
+	// Store the bitmap the way Draw would consume it, with padded rows converted to one byte per pixel.
+	if (!glyph->Missing && slot.format == FT_GLYPH_FORMAT_BITMAP && slot.bitmap.buffer && slot.bitmap.width && slot.bitmap.rows) {
+		FT_Bitmap target;
+		auto temporaryTarget = false;
+		const auto targetCleanup = CallOnDestruction([&face, &target, &temporaryTarget]() {
+			if (temporaryTarget)
+				Succ(FT_Bitmap_Done(face.GetLibraryUnprotected(), &target));
+		});
+		if (slot.bitmap.width != static_cast<unsigned>(slot.bitmap.pitch)) {
+			FT_Bitmap_Init(&target);
+			Succ(FT_Bitmap_Convert(face.GetLibraryUnprotected(), &slot.bitmap, &target, 1));
+			temporaryTarget = true;
+		} else
+			target = slot.bitmap;
+
+		glyph->NumGrays = static_cast<uint16_t>(target.num_grays);
+		glyph->Bitmap.assign(target.buffer, target.buffer + static_cast<size_t>(glyph->Width) * glyph->Rows);
+	}
+
+	cache->Store(m_pImpl->GlyphCacheFaceKey, c, loadFlags, glyph);
+	return glyph;
+}
+
+Sqex::FontCsv::GlyphMeasurement Sqex::FontCsv::FreeTypeFont::ToMeasurement(const FreeTypeGlyphCache::Glyph& glyph, SSIZE_T x, SSIZE_T y) const {
+	if (glyph.Missing)
+		return {true};
+
+	const auto ascent = Ascent();
+	constexpr auto a = SSIZE_T();
+	return GlyphMeasurement{
+		.empty = false,
+		.left = a + glyph.BitmapLeft,
+		.top = static_cast<SSIZE_T>(a + ascent - glyph.BitmapTop),
+		.right = static_cast<SSIZE_T>(a + glyph.BitmapLeft + glyph.Width),
+		.bottom = static_cast<SSIZE_T>(a + ascent - glyph.BitmapTop + glyph.Rows),
+		.advanceX = static_cast<SSIZE_T>(glyph.AdvanceX / 64 + m_advanceWidthDelta),
+	}.Translate(x, y);
+}
@@ -2,6 +2,7 @@
 
 #include "XivAlexanderCommon/Sqex/FontCsv/BaseDrawableFont.h"
 #include "XivAlexanderCommon/Sqex/FontCsv/BaseFont.h"
+#include "XivAlexanderCommon/Sqex/FontCsv/FreeTypeGlyphCache.h"
 #include "XivAlexanderCommon/Sqex/Texture.h"
 
 namespace Sqex::FontCsv {
@@ -37,6 +38,9 @@ namespace Sqex::FontCsv {
 			FT_Int32 loadFlags = FT_LOAD_DEFAULT);
 		~FreeTypeFont() override;
 
+		// Loads glyphs through cache from now on, and stores what had to be loaded from the font into it.
+		void UseGlyphCache(std::shared_ptr<FreeTypeGlyphCache> cache);
+
 		[[nodiscard]] bool HasCharacter(char32_t) const override;
 		[[nodiscard]] float Size() const override;
 		[[nodiscard]] const std::vector<char32_t>& GetAllCharacters() const override;
@@ -114,6 +118,11 @@ namespace Sqex::FontCsv {
 		};
 
 		FtFaceCtxMgr GetFace(char32_t c = std::numeric_limits<char32_t>::max(), FT_Int32 additionalFlags = 0) const;
+
+		// Returns nullptr if no glyph cache is in use.
+		[[nodiscard]] std::shared_ptr<const FreeTypeGlyphCache::Glyph> GetCachedGlyph(char32_t c, FT_Int32 additionalFlags = 0) const;
+
+		[[nodiscard]] GlyphMeasurement ToMeasurement(const FreeTypeGlyphCache::Glyph& glyph, SSIZE_T x, SSIZE_T y) const;
 	};
 
 	template<uint32_t Levels>
@@ -149,6 +158,13 @@ namespace Sqex::FontCsv {
 		using BaseDrawableFont<DestPixFmt, OpacityType>::Draw;
 
 		GlyphMeasurement Draw(Texture::MemoryBackedMipmap* to, SSIZE_T x, SSIZE_T y, char32_t c, const DestPixFmt& fgColor, const DestPixFmt& bgColor, OpacityType fgOpacity, OpacityType bgOpacity) const override {
+			if (const auto glyph = GetCachedGlyph(c, FT_LOAD_RENDER)) {
+				const auto bbox = ToMeasurement(*glyph, x, y);
+				if (!bbox.empty)
+					DrawBitmap(to, bbox, std::span(glyph->Bitmap), glyph->NumGrays, fgColor, bgColor, fgOpacity, bgOpacity);
+				return bbox;
+			}
+
 			const auto face = GetFace(c, FT_LOAD_RENDER);
 			const auto bbox = face.ToMeasurement(x, y);
 			if (bbox.empty)
@@ -167,39 +183,44 @@ namespace Sqex::FontCsv {
 			} else
 				target = face->glyph->bitmap;
 
-			const auto srcBuf = std::span(target.buffer, bbox.Area());
-
-			if (!srcBuf.empty()) {
-				const auto destWidth = static_cast<SSIZE_T>(to->Width);
-				const auto destHeight = static_cast<SSIZE_T>(to->Height);
-				const auto srcWidth = bbox.Width();
-				const auto srcHeight = bbox.Height();
-
-				GlyphMeasurement src = {false, 0, 0, srcWidth, srcHeight};
-				auto dest = bbox;
-				src.AdjustToIntersection(dest, srcWidth, srcHeight, destWidth, destHeight);
-
-				if (!src.EffectivelyEmpty() && !dest.EffectivelyEmpty()) {
-					auto destBuf = to->View<DestPixFmt>();
-					switch (target.num_grays) {
-						case 2:
-							RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<2>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
-							break;
-						case 4:
-							RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<4>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
-							break;
-						case 16:
-							RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<16>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
-							break;
-						case 256:
-							RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<256>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
-							break;
-						default:
-							throw std::invalid_argument("invalid num_grays");
-					}
-				}
-			}
+			DrawBitmap(to, bbox, std::span<const uint8_t>(target.buffer, bbox.Area()), target.num_grays, fgColor, bgColor, fgOpacity, bgOpacity);
 			return bbox;
 		}
+
+	private:
+		void DrawBitmap(Texture::MemoryBackedMipmap* to, const GlyphMeasurement& bbox, std::span<const uint8_t> srcBuf, int numGrays, const DestPixFmt& fgColor, const DestPixFmt& bgColor, OpacityType fgOpacity, OpacityType bgOpacity) const {
+			if (srcBuf.empty())
+				return;
+
+			const auto destWidth = static_cast<SSIZE_T>(to->Width);
+			const auto destHeight = static_cast<SSIZE_T>(to->Height);
+			const auto srcWidth = bbox.Width();
+			const auto srcHeight = bbox.Height();
+
+			GlyphMeasurement src = {false, 0, 0, srcWidth, srcHeight};
+			auto dest = bbox;
+			src.AdjustToIntersection(dest, srcWidth, srcHeight, destWidth, destHeight);
+
+			if (src.EffectivelyEmpty() || dest.EffectivelyEmpty())
+				return;
+
+			auto destBuf = to->View<DestPixFmt>();
+			switch (numGrays) {
+				case 2:
+					RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<2>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
+					break;
+				case 4:
+					RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<4>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
+					break;
+				case 16:
+					RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<16>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
+					break;
+				case 256:
+					RgbBitmapCopy<uint8_t, FreeTypeDrawingFont_GetEffectiveOpacity<256>, DestPixFmt, OpacityType>::CopyTo(src, dest, &srcBuf[0], &destBuf[0], srcWidth, srcHeight, destWidth, fgColor, bgColor, fgOpacity, bgOpacity, BaseDrawableFont<DestPixFmt, OpacityType>::Gamma());
+					break;
+				default:
+					throw std::invalid_argument("invalid num_grays");
+			}
+		}
 	};
 }
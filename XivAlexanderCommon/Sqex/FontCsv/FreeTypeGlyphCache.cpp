@@ -0,0 +1,246 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/FontCsv/FreeTypeGlyphCache.h"
+
+#include <bit>
+
+#include "XivAlexanderCommon/Utils/Utils.h"
+#include "XivAlexanderCommon/Utils/Win32/Handle.h"
+
+static constexpr char FileSignature[8] = { 'X', 'A', 'F', 'T', 'G', 'C', 0, 0 };
+static constexpr auto FileExtension = ".bin";
+static constexpr auto TempFileExtension = ".tmp";
+
+namespace {
+	struct FileHeader {
+		char Signature[8];
+		uint32_t Version;
+		uint32_t GlyphCount;
+	};
+
+	struct GlyphHeader {
+		char32_t Character;
+		int32_t LoadFlags;
+		int32_t BitmapLeft;
+		int32_t BitmapTop;
+		uint32_t Width;
+		uint32_t Rows;
+		int32_t AdvanceX;
+		uint16_t NumGrays;
+		uint8_t Missing;
+		uint8_t Padding;
+		uint32_t BitmapSize;
+	};
+}
+
+static std::string Sha1ToHex(const Sqex::Sqpack::Sha1Value& value) {
+	static constexpr char Digits[] = "0123456789abcdef";
+	std::string result;
+	result.reserve(sizeof value.Value * 2);
+	for (const auto c : value.Value) {
+		result += Digits[static_cast<uint8_t>(c) >> 4];
+		result += Digits[static_cast<uint8_t>(c) & 0xF];
+	}
+	return result;
+}
+
+template<typename T>
+static T ReadFromBuffer(std::span<const uint8_t> buf, size_t& offset) {
+	if (buf.size() - offset < sizeof T)
+		throw std::runtime_error("Glyph cache file is truncated");
+	T res;
+	memcpy(&res, &buf[offset], sizeof T);
+	offset += sizeof T;
+	return res;
+}
+
+template<typename T>
+static void AppendToBuffer(std::vector<uint8_t>& buf, const T& value) {
+	const auto ptr = reinterpret_cast<const uint8_t*>(&value);
+	buf.insert(buf.end(), ptr, ptr + sizeof T);
+}
+
+Sqex::FontCsv::FreeTypeGlyphCache::FreeTypeGlyphCache(std::filesystem::path directory)
+	: m_directory(std::move(directory)) {
+}
+
+std::string Sqex::FontCsv::FreeTypeGlyphCache::MakeFaceKey(FT_Library library, const std::filesystem::path& path, std::span<const uint8_t> data, int faceIndex, float size) {
+	std::optional<Sqpack::Sha1Value> hash;
+	{
+		const auto lock = std::lock_guard(m_mtx);
+		if (const auto it = m_fontHashes.find(path); it != m_fontHashes.end())
+			hash = it->second;
+	}
+
+	// Hash outside the lock, as a font file can take a while to go through.
+	if (!hash) {
+		hash.emplace();
+		hash->SetFrom(data);
+
+		const auto lock = std::lock_guard(m_mtx);
+		m_fontHashes.emplace(path, *hash);
+	}
+
+	FT_Int major, minor, patch;
+	FT_Library_Version(library, &major, &minor, &patch);
+
+	return std::format("{}_{}_{:08x}_ft{}.{}.{}", Sha1ToHex(*hash), faceIndex, std::bit_cast<uint32_t>(size), major, minor, patch);
+}
+
+Sqex::FontCsv::FreeTypeGlyphCache::Face Sqex::FontCsv::FreeTypeGlyphCache::ReadFace(const std::filesystem::path& path) {
+	Face face;
+	if (!exists(path))
+		return face;
+
+	try {
+		const auto file = Utils::Win32::Handle::FromCreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0);
+		const auto fileSize = file.GetFileSize();
+		if (fileSize > FileSizeMax)
+			return face;
+
+		const auto buf = file.Read<uint8_t>(0, static_cast<size_t>(fileSize));
+		size_t offset = 0;
+
+		const auto header = ReadFromBuffer<FileHeader>(buf, offset);
+		if (memcmp(header.Signature, FileSignature, sizeof FileSignature) != 0 || header.Version != Version)
+			return face;
+
+		for (uint32_t i = 0; i < header.GlyphCount; ++i) {
+			const auto glyphHeader = ReadFromBuffer<GlyphHeader>(buf, offset);
+			if (buf.size() - offset < glyphHeader.BitmapSize)
+				throw std::runtime_error("Glyph cache file is truncated");
+
+			auto glyph = std::make_shared<Glyph>(Glyph{
+				.Missing = !!glyphHeader.Missing,
+				.BitmapLeft = glyphHeader.BitmapLeft,
+				.BitmapTop = glyphHeader.BitmapTop,
+				.Width = glyphHeader.Width,
+				.Rows = glyphHeader.Rows,
+				.AdvanceX = glyphHeader.AdvanceX,
+				.NumGrays = glyphHeader.NumGrays,
+				.Bitmap = std::vector<uint8_t>(buf.begin() + static_cast<ptrdiff_t>(offset), buf.begin() + static_cast<ptrdiff_t>(offset + glyphHeader.BitmapSize)),
+			});
+			offset += glyphHeader.BitmapSize;
+
+			// Draw relies on a rendered glyph having one byte per pixel in a known number of gray levels.
+			if (!glyph->Bitmap.empty() || (!glyph->Missing && (glyphHeader.LoadFlags & FT_LOAD_RENDER) && glyph->Width && glyph->Rows)) {
+				if (glyph->Bitmap.size() != static_cast<size_t>(glyph->Width) * glyph->Rows)
+					throw std::runtime_error("Glyph cache file has a bitmap of wrong size");
+				if (glyph->NumGrays != 2 && glyph->NumGrays != 4 && glyph->NumGrays != 16 && glyph->NumGrays != 256)
+					throw std::runtime_error("Glyph cache file has an invalid number of gray levels");
+			}
+
+			face.Glyphs.insert_or_assign(std::make_pair(glyphHeader.Character, glyphHeader.LoadFlags), std::move(glyph));
+		}
+	} catch (const std::exception&) {
+		face.Glyphs.clear();
+	}
+	return face;
+}
+
+void Sqex::FontCsv::FreeTypeGlyphCache::EnsureFaceLoaded(const std::string& faceKey) {
+	{
+		const auto lock = std::lock_guard(m_mtx);
+		if (m_faces.contains(faceKey))
+			return;
+	}
+
+	// Read outside the lock, so that glyphs of other faces remain accessible meanwhile.
+	auto face = ReadFace(m_directory / (faceKey + FileExtension));
+
+	// If another thread has loaded the same face meanwhile, keep the one that may already have glyphs stored into.
+	const auto lock = std::lock_guard(m_mtx);
+	m_faces.emplace(faceKey, std::move(face));
+}
+
+std::shared_ptr<const Sqex::FontCsv::FreeTypeGlyphCache::Glyph> Sqex::FontCsv::FreeTypeGlyphCache::Find(const std::string& faceKey, char32_t c, int32_t loadFlags) {
+	EnsureFaceLoaded(faceKey);
+
+	const auto lock = std::lock_guard(m_mtx);
+	const auto& face = m_faces.at(faceKey);
+	if (const auto it = face.Glyphs.find(std::make_pair(c, loadFlags)); it != face.Glyphs.end()) {
+		m_statistics.Hits++;
+		m_statistics.HitBytes += it->second->Bitmap.size();
+		return it->second;
+	}
+
+	m_statistics.Misses++;
+	return nullptr;
+}
+
+void Sqex::FontCsv::FreeTypeGlyphCache::Store(const std::string& faceKey, char32_t c, int32_t loadFlags, std::shared_ptr<const Glyph> glyph) {
+	EnsureFaceLoaded(faceKey);
+
+	const auto lock = std::lock_guard(m_mtx);
+	auto& face = m_faces.at(faceKey);
+	m_statistics.StoredBytes += glyph->Bitmap.size();
+	face.Glyphs.insert_or_assign(std::make_pair(c, loadFlags), std::move(glyph));
+	face.Dirty = true;
+}
+
+Sqex::FontCsv::FreeTypeGlyphCache::Statistics Sqex::FontCsv::FreeTypeGlyphCache::GetStatistics() const {
+	const auto lock = std::lock_guard(m_mtx);
+	return m_statistics;
+}
+
+void Sqex::FontCsv::FreeTypeGlyphCache::Save() {
+	const auto lock = std::lock_guard(m_mtx);
+
+	create_directories(m_directory);
+	const auto now = std::filesystem::file_time_type::clock::now();
+
+	for (auto& [faceKey, face] : m_faces) {
+		const auto path = m_directory / (faceKey + FileExtension);
+		if (!face.Dirty) {
+			// Keep files that are still in use from expiring.
+			std::error_code ec;
+			if (exists(path, ec))
+				last_write_time(path, now, ec);
+			continue;
+		}
+
+		std::vector<uint8_t> buf;
+		FileHeader header{};
+		memcpy(header.Signature, FileSignature, sizeof FileSignature);
+		header.Version = Version;
+		header.GlyphCount = static_cast<uint32_t>(face.Glyphs.size());
+		AppendToBuffer(buf, header);
+
+		for (const auto& [key, glyph] : face.Glyphs) {
+			AppendToBuffer(buf, GlyphHeader{
+				.Character = key.first,
+				.LoadFlags = key.second,
+				.BitmapLeft = glyph->BitmapLeft,
+				.BitmapTop = glyph->BitmapTop,
+				.Width = glyph->Width,
+				.Rows = glyph->Rows,
+				.AdvanceX = glyph->AdvanceX,
+				.NumGrays = glyph->NumGrays,
+				.Missing = static_cast<uint8_t>(glyph->Missing ? 1 : 0),
+				.BitmapSize = static_cast<uint32_t>(glyph->Bitmap.size()),
+			});
+			buf.insert(buf.end(), glyph->Bitmap.begin(), glyph->Bitmap.end());
+		}
+
+		auto tempPath = path;
+		tempPath += TempFileExtension;
+		Utils::Win32::Handle::FromCreateFile(tempPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, 0)
+			.Write(0, std::span(buf));
+		std::filesystem::rename(tempPath, path);
+		face.Dirty = false;
+	}
+
+	for (const auto& entry : std::filesystem::directory_iterator(m_directory)) {
+		// Temporary files are left behind only by writes that failed midway, so they expire even if their face is in use.
+		if (entry.path().extension() == TempFileExtension) {
+			if (entry.path().stem().extension() != FileExtension)
+				continue;
+		} else if (entry.path().extension() != FileExtension)
+			continue;
+		else if (m_faces.contains(Utils::ToUtf8(entry.path().stem().wstring())))
+			continue;
+
+		std::error_code ec;
+		if (const auto lastWriteTime = entry.last_write_time(ec); !ec && now - lastWriteTime > UnusedFileLifetime)
+			remove(entry.path(), ec);
+	}
+}
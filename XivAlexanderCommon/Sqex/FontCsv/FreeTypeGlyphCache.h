@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include "XivAlexanderCommon/Sqex/Sqpack.h"
+
+namespace Sqex::FontCsv {
+	/*
+	 * Persistent store of glyphs FreeTypeFont has loaded, so that regenerating fonts need not rasterize unchanged glyphs again.
+	 * Each face gets its own file, named after the hash of the font file, the face index, the size, and the FreeType version;
+	 * glyphs in a file are keyed by the character and the load flags that were in effect.
+	 * Files that were neither used during a run nor modified for UnusedFileLifetime are deleted on Save, as are leftovers of failed writes of that age.
+	 */
+	class FreeTypeGlyphCache {
+	public:
+		static constexpr uint32_t Version = 2;
+		static constexpr uint64_t FileSizeMax = 256 * 1048576;
+		static constexpr auto UnusedFileLifetime = std::chrono::hours(24 * 30);
+
+		struct Glyph {
+			bool Missing{};  // glyph_index was 0
+			int32_t BitmapLeft{};
+			int32_t BitmapTop{};
+			uint32_t Width{};
+			uint32_t Rows{};
+			int32_t AdvanceX{};  // in 26.6 fixed point
+			uint16_t NumGrays{};
+			std::vector<uint8_t> Bitmap;  // one byte per pixel with no row padding; empty unless the glyph was rendered
+		};
+
+		struct Statistics {
+			uint64_t Hits{};
+			uint64_t Misses{};
+			uint64_t HitBytes{};  // bitmap bytes that did not have to be rasterized again
+			uint64_t StoredBytes{};
+		};
+
+	private:
+		struct Face {
+			std::map<std::pair<char32_t, int32_t>, std::shared_ptr<const Glyph>> Glyphs;
+			bool Dirty = false;
+		};
+
+		const std::filesystem::path m_directory;
+
+		mutable std::mutex m_mtx;
+		std::map<std::string, Face> m_faces;
+		std::map<std::filesystem::path, Sqpack::Sha1Value> m_fontHashes;  // computed during this run
+		Statistics m_statistics;
+
+		// Reads a face file; a file that is missing or unusable yields an empty face.
+		static Face ReadFace(const std::filesystem::path& path);
+
+		// Must be called without holding m_mtx, as a face file can be large.
+		void EnsureFaceLoaded(const std::string& faceKey);
+
+	public:
+		FreeTypeGlyphCache(std::filesystem::path directory);
+
+		// Identifies a face for use with Find and Store; data should be the content of the font file at path.
+		// Glyphs rasterized by a different version of FreeType end up under a different key.
+		[[nodiscard]] std::string MakeFaceKey(FT_Library library, const std::filesystem::path& path, std::span<const uint8_t> data, int faceIndex, float size);
+
+		[[nodiscard]] std::shared_ptr<const Glyph> Find(const std::string& faceKey, char32_t c, int32_t loadFlags);
+		void Store(const std::string& faceKey, char32_t c, int32_t loadFlags, std::shared_ptr<const Glyph> glyph);
+
+		[[nodiscard]] Statistics GetStatistics() const;
+
+		void Save();
+	};
+}
@@ -1,6 +1,35 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/SeString.h"
 
+// Shared by SeString, which owns its payloads, and SeStringView, which does not.
+template<typename TPayload>
+static void AppendEscaped(std::string& res, std::string_view parsed, std::span<const TPayload> payloads, bool newlineAsCarriageReturn) {
+	const auto specialCharacters = newlineAsCarriageReturn ? std::string_view("\x02\r") : std::string_view("\x02");
+
+	size_t escapeIndex = 0;
+	while (!parsed.empty()) {
+		const auto textLength = std::min(parsed.find_first_of(specialCharacters), parsed.size());
+		res.append(parsed.substr(0, textLength));
+		parsed = parsed.substr(textLength);
+		if (parsed.empty())
+			break;
+
+		if (parsed.front() == '\r') {
+			res += "\x02\x10\x01\x03";  // STX, SeExpressionUint32(PayloadType(NewLine)), SeExpressionUint32(0), ETX
+		} else {
+			if (escapeIndex == payloads.size())
+				throw std::invalid_argument("more sentinel characters than payloads");
+			const auto& payload = payloads[escapeIndex++];
+			res += Sqex::SeStringView::StartOfText;
+			Sqex::SeExpressionUint32(payload.Type()).EncodeAppendTo(res);
+			Sqex::SeExpressionUint32(static_cast<uint32_t>(payload.Data().size())).EncodeAppendTo(res);
+			res += payload.Data();
+			res += Sqex::SeStringView::EndOfText;
+		}
+		parsed = parsed.substr(1);
+	}
+}
+
 void Sqex::SeString::Parse() const {
 	if (!m_parsed.empty() || m_escaped.empty())
 		return;
@@ -9,49 +38,18 @@ void Sqex::SeString::Parse() const {
 	std::vector<SePayload> payloads;
 	parsed.reserve(m_escaped.size());
 
-	std::string_view remaining(m_escaped);
-	while (!remaining.empty()) {
-		if (remaining[0] == StartOfText) {
-			if (remaining.size() < 3)
-				throw std::invalid_argument("STX occurred but there are less than 3 remaining bytes");
-			remaining = remaining.substr(1);
-
-			const auto payloadTypeLength = SeExpressionUint32::ExpressionLength(remaining[0]);
-			if (payloadTypeLength == 0)
-				throw std::invalid_argument("payload type length specifier is not a SeExpressionUint32");
-			else if (remaining.size() < payloadTypeLength)
-				throw std::invalid_argument("payload type length specifier is incomplete");
-			const auto payloadType = SeExpressionUint32(remaining);
-			remaining = remaining.substr(payloadTypeLength);
-
-			const auto lengthLength = SeExpressionUint32::ExpressionLength(remaining[0]);
-			if (lengthLength == 0)
-				throw std::invalid_argument("payload data length specifier is not a SeExpressionUint32");
-			else if (remaining.size() < lengthLength)
-				throw std::invalid_argument("payload data length specifier is incomplete");
-			const auto payloadLength = SeExpressionUint32(remaining);
-			remaining = remaining.substr(lengthLength);
-
-			if (remaining.size() < payloadLength)
-				throw std::invalid_argument("payload is incomplete");
-			auto payload = SePayload(payloadType, remaining.substr(0, payloadLength));
-			remaining = remaining.substr(payloadLength);
-
-			if (remaining.empty() || remaining[0] != EndOfText)
-				throw std::invalid_argument("ETX not found");
-			remaining = remaining.substr(1);
-
+	SeStringView(std::string_view(m_escaped)).Visit(
+		[&parsed](std::string_view text) {
+			parsed += text;
+		},
+		[&](const SePayloadView& payload) {
 			if (m_newlineAsCarriageReturn && payload.Type() == SePayload::PayloadType::NewLine) {
 				parsed.push_back('\r');
 			} else {
 				parsed.push_back(StartOfText);
-				payloads.emplace_back(std::move(payload));
+				payloads.emplace_back(payload.Type(), payload.Data());
 			}
-		} else {
-			parsed.push_back(remaining.front());
-			remaining = remaining.substr(1);
-		}
-	}
+		});
 
 	m_parsed = std::move(parsed);
 	m_payloads = std::move(payloads);
@@ -71,25 +69,112 @@ void Sqex::SeString::Escape() const {
 
 	std::string res;
 	res.reserve(reserveSize);
-	
-	size_t escapeIndex = 0;
-	for (const auto chr : m_parsed) {
-		if (chr == '\r' && m_newlineAsCarriageReturn) {
-			res += "\x02\x10\x01\x03";  // STX, SeExpressionUint32(PayloadType(NewLine)), SeExpressionUint32(0), ETX
-		} else if (chr != StartOfText) {
-			res += chr;
-		} else {
-			const auto ptr = res.size();
-			const auto& payload = m_payloads[escapeIndex++];
-			res += StartOfText;
-			SeExpressionUint32(payload.Type()).EncodeAppendTo(res);
-			SeExpressionUint32(static_cast<uint32_t>(payload.Data().size())).EncodeAppendTo(res);
-			res += payload.Data();
-			res += EndOfText;
-		}
+	AppendEscaped(res, m_parsed, std::span<const SePayload>(m_payloads), m_newlineAsCarriageReturn);
+	m_escaped = std::move(res);
+}
+
+Sqex::SePayloadView Sqex::SeStringView::ConsumePayload(std::string_view& remaining) {
+	if (remaining.size() < 3)
+		throw std::invalid_argument("STX occurred but there are less than 3 remaining bytes");
+	remaining = remaining.substr(1);
+
+	const auto payloadTypeLength = SeExpressionUint32::ExpressionLength(remaining[0]);
+	if (payloadTypeLength == 0)
+		throw std::invalid_argument("payload type length specifier is not a SeExpressionUint32");
+	else if (remaining.size() < payloadTypeLength)
+		throw std::invalid_argument("payload type length specifier is incomplete");
+	const auto payloadType = SeExpressionUint32(remaining);
+	remaining = remaining.substr(payloadTypeLength);
+
+	if (remaining.empty())
+		throw std::invalid_argument("payload data length specifier is missing");
+	const auto lengthLength = SeExpressionUint32::ExpressionLength(remaining[0]);
+	if (lengthLength == 0)
+		throw std::invalid_argument("payload data length specifier is not a SeExpressionUint32");
+	else if (remaining.size() < lengthLength)
+		throw std::invalid_argument("payload data length specifier is incomplete");
+	const auto payloadLength = SeExpressionUint32(remaining);
+	remaining = remaining.substr(lengthLength);
+
+	if (remaining.size() < payloadLength)
+		throw std::invalid_argument("payload is incomplete");
+	const auto payload = SePayloadView(payloadType, remaining.substr(0, payloadLength));
+	remaining = remaining.substr(payloadLength);
+
+	if (remaining.empty() || remaining[0] != EndOfText)
+		throw std::invalid_argument("ETX not found");
+	remaining = remaining.substr(1);
+
+	return payload;
+}
+
+Sqex::SeString Sqex::SeStringView::ToSeString(bool newlineAsCarriageReturn) const {
+	SeString res{ std::string(m_escaped) };
+	if (newlineAsCarriageReturn)
+		res.NewlineAsCarriageReturn(true);
+	return res;
+}
+
+void Sqex::SeStringView::AppendParsedTo(std::string& parsed, std::vector<SePayloadView>& payloads, bool newlineAsCarriageReturn) const {
+	Visit(
+		[&parsed](std::string_view text) {
+			parsed += text;
+		},
+		[&](const SePayloadView& payload) {
+			if (newlineAsCarriageReturn && payload.Type() == SePayload::PayloadType::NewLine) {
+				parsed.push_back('\r');
+			} else {
+				parsed.push_back(StartOfText);
+				payloads.emplace_back(payload);
+			}
+		});
+}
+
+void Sqex::SeStringView::AppendEscapedTo(std::string& escaped, std::string_view parsed, std::span<const SePayloadView> payloads, bool newlineAsCarriageReturn) {
+	AppendEscaped(escaped, parsed, payloads, newlineAsCarriageReturn);
+}
+
+Sqex::SeStringColumn::SeStringColumn(std::span<const std::string_view> escapedCells, bool newlineAsCarriageReturn)
+	: m_newlineAsCarriageReturn(newlineAsCarriageReturn) {
+	size_t totalSize = 0;
+	for (const auto& cell : escapedCells)
+		totalSize += cell.size();
+	m_parsed.reserve(totalSize);
+	m_cells.reserve(escapedCells.size());
+
+	for (const auto& escaped : escapedCells) {
+		auto& cell = m_cells.emplace_back(Cell{
+			.TextOffset = m_parsed.size(),
+			.PayloadOffset = m_payloads.size(),
+		});
+		SeStringView(escaped).AppendParsedTo(m_parsed, m_payloads, m_newlineAsCarriageReturn);
+		cell.TextLength = m_parsed.size() - cell.TextOffset;
+		cell.PayloadCount = m_payloads.size() - cell.PayloadOffset;
 	}
+}
 
-	m_escaped = std::move(res);
+std::vector<std::string_view> Sqex::SeStringColumn::Escape(std::string& buffer, std::span<const std::string_view> parsedOverrides) const {
+	if (!parsedOverrides.empty() && parsedOverrides.size() != m_cells.size())
+		throw std::invalid_argument("parsedOverrides must be empty or have one item per cell");
+
+	std::vector<size_t> offsets;
+	offsets.reserve(m_cells.size() + 1);
+	for (size_t i = 0; i < m_cells.size(); ++i) {
+		const auto parsed = parsedOverrides.empty() ? Parsed(i) : parsedOverrides[i];
+		const auto payloads = Payloads(i);
+		if (static_cast<size_t>(std::ranges::count(parsed, SeStringView::StartOfText)) != payloads.size())
+			throw std::invalid_argument(std::format("cell {}: number of sentinel characters does not match the number of payloads", i));
+
+		offsets.emplace_back(buffer.size());
+		AppendEscaped(buffer, parsed, payloads, m_newlineAsCarriageReturn);
+	}
+	offsets.emplace_back(buffer.size());
+
+	std::vector<std::string_view> res;
+	res.reserve(m_cells.size());
+	for (size_t i = 0; i < m_cells.size(); ++i)
+		res.emplace_back(std::string_view(buffer).substr(offsets[i], offsets[i + 1] - offsets[i]));
+	return res;
 }
 
 size_t Sqex::SeExpressionUint32::Length() const {
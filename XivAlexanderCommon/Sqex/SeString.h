@@ -131,6 +131,26 @@ namespace Sqex {
 		}
 	};
 
+	// Non-owning counterpart of SePayload; the data points into the escaped string it was read from.
+	class SePayloadView {
+		uint32_t m_type;
+		std::string_view m_data;
+
+	public:
+		SePayloadView(uint32_t payloadType = SePayload::PayloadType::Unset, std::string_view data = {})
+			: m_type(payloadType)
+			, m_data(data) {
+		}
+
+		uint32_t Type() const {
+			return m_type;
+		}
+
+		std::string_view Data() const {
+			return m_data;
+		}
+	};
+
 	class SeString {
 		static constexpr auto StartOfText = '\x02';
 		static constexpr auto EndOfText = '\x03';
@@ -243,4 +263,95 @@ namespace Sqex {
 				throw std::invalid_argument(std::format("number of sentinel characters({}) != expected number of sentinel characters({})", cnt, components.size()));
 		}
 	};
+
+	// Read-only view of an escaped SeString, for going through strings without copying them out of their source buffer.
+	// Text runs and payloads handed out point into the viewed buffer, which has to outlive them.
+	class SeStringView {
+		std::string_view m_escaped;
+
+	public:
+		static constexpr auto StartOfText = '\x02';
+		static constexpr auto EndOfText = '\x03';
+
+		SeStringView(std::string_view escaped = {})
+			: m_escaped(escaped) {
+		}
+
+		SeStringView(const SeString& s)
+			: m_escaped(s.Escaped()) {
+		}
+
+		[[nodiscard]] std::string_view Escaped() const {
+			return m_escaped;
+		}
+
+		[[nodiscard]] bool Empty() const {
+			return m_escaped.empty();
+		}
+
+		// Calls onText(std::string_view) for every run of plain text and onPayload(const SePayloadView&) for every payload, in order.
+		// Throws std::invalid_argument if the string is malformed.
+		template<typename TOnText, typename TOnPayload>
+		void Visit(TOnText&& onText, TOnPayload&& onPayload) const {
+			for (auto remaining = m_escaped; !remaining.empty();) {
+				const auto textLength = std::min(remaining.find(StartOfText), remaining.size());
+				if (textLength) {
+					onText(remaining.substr(0, textLength));
+					remaining = remaining.substr(textLength);
+				}
+				if (!remaining.empty())
+					onPayload(ConsumePayload(remaining));
+			}
+		}
+
+		[[nodiscard]] SeString ToSeString(bool newlineAsCarriageReturn = false) const;
+
+		// Appends the parsed form to parsed, with every payload replaced by StartOfText and appended to payloads.
+		void AppendParsedTo(std::string& parsed, std::vector<SePayloadView>& payloads, bool newlineAsCarriageReturn = false) const;
+
+		// Inverse of AppendParsedTo; parsed must contain exactly one StartOfText per payload.
+		static void AppendEscapedTo(std::string& escaped, std::string_view parsed, std::span<const SePayloadView> payloads, bool newlineAsCarriageReturn = false);
+
+	private:
+		// Reads the payload at the beginning of remaining, and advances remaining past it.
+		static SePayloadView ConsumePayload(std::string_view& remaining);
+	};
+
+	// Parses a whole column of escaped strings at once, such as one returned from Excel::ExdReader::ExtractStringColumn,
+	// into a buffer shared by all cells, instead of allocating for every cell.
+	// Payloads point into the escaped strings, which have to outlive this object.
+	class SeStringColumn {
+		struct Cell {
+			size_t TextOffset;
+			size_t TextLength;
+			size_t PayloadOffset;
+			size_t PayloadCount;
+		};
+
+		bool m_newlineAsCarriageReturn;
+		std::string m_parsed;
+		std::vector<SePayloadView> m_payloads;
+		std::vector<Cell> m_cells;
+
+	public:
+		SeStringColumn(std::span<const std::string_view> escapedCells, bool newlineAsCarriageReturn = false);
+
+		[[nodiscard]] size_t Size() const {
+			return m_cells.size();
+		}
+
+		[[nodiscard]] std::string_view Parsed(size_t index) const {
+			const auto& cell = m_cells.at(index);
+			return std::string_view(m_parsed).substr(cell.TextOffset, cell.TextLength);
+		}
+
+		[[nodiscard]] std::span<const SePayloadView> Payloads(size_t index) const {
+			const auto& cell = m_cells.at(index);
+			return std::span(m_payloads).subspan(cell.PayloadOffset, cell.PayloadCount);
+		}
+
+		// Escapes every cell back to back into buffer, and returns the views of each escaped cell in it.
+		// parsedOverrides, if not empty, supplies a replacement parsed text for every cell; each must keep the payload placeholders of the cell it replaces.
+		std::vector<std::string_view> Escape(std::string& buffer, std::span<const std::string_view> parsedOverrides = {}) const;
+	};
 }
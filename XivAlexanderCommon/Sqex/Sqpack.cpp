@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Sqpack.h"
 
+#include <array>
+#include <emmintrin.h>
+
 const char Sqex::Sqpack::SqpackHeader::Signature_Value[12] = {
 	'S', 'q', 'P', 'a', 'c', 'k', 0, 0, 0, 0, 0, 0,
 };
@@ -274,33 +277,120 @@ uint64_t Sqex::Sqpack::SqData::FileEntryHeader::GetTotalEntrySize() const {
 	return HeaderSize + GetDataSize();
 }
 
-uint32_t Sqex::Sqpack::SqexHash(const char* data, size_t len) {
-	std::string normalizedText;
-	if (len == SIZE_MAX) {
-		normalizedText = data;
-		len = normalizedText.size();
-	} else
-		normalizedText = {data, len};
-	for (auto& c : normalizedText) {
+namespace {
+	// Slice k holds the hash contribution of a byte followed by k zero bytes; slices 0 to 3 equal SqexHashTable.
+	constexpr auto SqexHashTable16 = []() {
+		std::array<std::array<uint32_t, 256>, 16> table{};
+		for (uint32_t i = 0; i < 256; ++i) {
+			auto v = i;
+			for (auto j = 0; j < 8; ++j)
+				v = (v >> 1) ^ (v & 1 ? 0xEDB88320UL : 0);
+			table[0][i] = v;
+		}
+		for (size_t k = 1; k < table.size(); ++k)
+			for (size_t i = 0; i < 256; ++i)
+				table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+		return table;
+	}();
+	static_assert(SqexHashTable16[0][1] == 0x77073096 && SqexHashTable16[3][255] == 0xDE0506F1);
+
+	char NormalizeSqexHashChar(char c) {
 		if ('A' <= c && c <= 'Z')
-			c -= 'A' - 'a';
-		else if (c == '\\')
-			c = '/';
+			return static_cast<char>(c - 'A' + 'a');
+		if (c == '\\')
+			return '/';
+		return c;
+	}
+
+	__m128i NormalizeSqexHashBlock(__m128i v) {
+		// Bytes >= 0x80 compare as negative, so they never count as uppercase.
+		const auto isUpper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+		v = _mm_add_epi8(v, _mm_and_si128(isUpper, _mm_set1_epi8('a' - 'A')));
+		const auto isBackslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+		return _mm_xor_si128(v, _mm_and_si128(isBackslash, _mm_set1_epi8('\\' ^ '/')));
+	}
+}
+
+Sqex::Sqpack::SqexHasher& Sqex::Sqpack::SqexHasher::Update(const char* data, size_t len) {
+	const auto& t = SqexHashTable16;
+	auto crc = m_state;
+
+	// Slicing-by-16: normalize 16 bytes at once and fold them with one lookup per byte, all independent.
+	for (; len >= 16; data += 16, len -= 16) {
+		alignas(16) uint32_t w[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(w), NormalizeSqexHashBlock(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data))));
+		w[0] ^= crc;
+		crc = t[15][w[0] & 0xFF] ^ t[14][(w[0] >> 8) & 0xFF] ^ t[13][(w[0] >> 16) & 0xFF] ^ t[12][w[0] >> 24]
+			^ t[11][w[1] & 0xFF] ^ t[10][(w[1] >> 8) & 0xFF] ^ t[9][(w[1] >> 16) & 0xFF] ^ t[8][w[1] >> 24]
+			^ t[7][w[2] & 0xFF] ^ t[6][(w[2] >> 8) & 0xFF] ^ t[5][(w[2] >> 16) & 0xFF] ^ t[4][w[2] >> 24]
+			^ t[3][w[3] & 0xFF] ^ t[2][(w[3] >> 8) & 0xFF] ^ t[1][(w[3] >> 16) & 0xFF] ^ t[0][w[3] >> 24];
+	}
+
+	for (; len; ++data, --len)
+		crc = t[0][(crc ^ static_cast<uint8_t>(NormalizeSqexHashChar(*data))) & 0xFF] ^ (crc >> 8);
+
+	m_state = crc;
+	return *this;
+}
+
+Sqex::Sqpack::SqexHasher& Sqex::Sqpack::SqexHasher::Update(std::wstring_view text) {
+	char buf[256];
+	size_t used = 0;
+	for (size_t i = 0; i < text.size(); ++i) {
+		if (used + 4 > sizeof buf) {
+			Update(buf, used);
+			used = 0;
+		}
+
+		uint32_t codepoint = text[i];
+		if (0xD800 <= codepoint && codepoint < 0xDC00 && i + 1 < text.size() && 0xDC00 <= text[i + 1] && text[i + 1] < 0xE000) {
+			codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (text[i + 1] - 0xDC00);
+			++i;
+		} else if (0xD800 <= codepoint && codepoint < 0xE000)
+			codepoint = 0xFFFD;  // unpaired surrogate; WideCharToMultiByte substitutes the same
+
+		if (codepoint < 0x80) {
+			buf[used++] = static_cast<char>(codepoint);
+		} else if (codepoint < 0x800) {
+			buf[used++] = static_cast<char>(0xC0 | (codepoint >> 6));
+			buf[used++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+		} else if (codepoint < 0x10000) {
+			buf[used++] = static_cast<char>(0xE0 | (codepoint >> 12));
+			buf[used++] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+			buf[used++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+		} else {
+			buf[used++] = static_cast<char>(0xF0 | (codepoint >> 18));
+			buf[used++] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+			buf[used++] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+			buf[used++] = static_cast<char>(0x80 | (codepoint & 0x3F));
+		}
 	}
-	size_t i = 0;
-	uint32_t result = 0xFFFFFFFFUL;
-	for (; i < (len & ~3); i += 4) {
-		result ^= *reinterpret_cast<const uint32_t*>(&normalizedText[i]);
-		result = SqexHashTable[3][result & 0xFF] ^
-			SqexHashTable[2][(result >> 8) & 0xFF] ^
-			SqexHashTable[1][(result >> 16) & 0xFF] ^
-			SqexHashTable[0][(result >> 24) & 0xFF];
+	return Update(buf, used);
+}
+
+template<typename TElem>
+static Sqex::Sqpack::SqexPathHashes SqexHashPathImpl(std::basic_string_view<TElem> normalizedPath) {
+	static constexpr TElem Separators[]{ static_cast<TElem>('/'), static_cast<TElem>('\\') };
+	const auto sep = normalizedPath.find_last_of(std::basic_string_view<TElem>(Separators, std::size(Separators)));
+	Sqex::Sqpack::SqexHasher path;
+	if (sep == std::basic_string_view<TElem>::npos) {
+		Sqex::Sqpack::SqexHasher name;
+		name.Update(normalizedPath);
+		return { path.Value(), name.Value(), name.Value() };
 	}
 
-	for (; i < len; ++i)
-		result = SqexHashTable[0][(result ^ normalizedText[i]) & 0xFF] ^ (result >> 8);
+	path.Update(normalizedPath.substr(0, sep));
+	Sqex::Sqpack::SqexHasher name;
+	name.Update(normalizedPath.substr(sep + 1));
+	auto full = path;
+	full.Update(normalizedPath.substr(sep));
+	return { path.Value(), name.Value(), full.Value() };
+}
 
-	return result;
+uint32_t Sqex::Sqpack::SqexHash(const char* data, size_t len) {
+	if (len == SIZE_MAX)
+		len = strlen(data);
+	return SqexHasher().Update(data, len).Value();
 }
 
 uint32_t Sqex::Sqpack::SqexHash(const std::string& text) {
@@ -312,7 +402,22 @@ uint32_t Sqex::Sqpack::SqexHash(const std::string_view& text) {
 }
 
 uint32_t Sqex::Sqpack::SqexHash(const std::filesystem::path& path) {
-	return SqexHash(ToUtf8(path.lexically_normal().wstring()));
+	return SqexHasher().Update(std::wstring_view(path.lexically_normal().native())).Value();
+}
+
+Sqex::Sqpack::SqexPathHashes Sqex::Sqpack::SqexHashPath(std::string_view normalizedPath) {
+	return SqexHashPathImpl(normalizedPath);
+}
+
+Sqex::Sqpack::SqexPathHashes Sqex::Sqpack::SqexHashPath(std::wstring_view normalizedPath) {
+	return SqexHashPathImpl(normalizedPath);
+}
+
+Sqex::Sqpack::SqexPathHashes Sqex::Sqpack::SqexHashPath(const std::filesystem::path& normalizedPath) {
+	// parent_path() keeps root names and root directories, which splitting at the last separator would drop.
+	if (normalizedPath.has_root_path())
+		return { SqexHash(normalizedPath.parent_path()), SqexHash(normalizedPath.filename()), SqexHash(normalizedPath) };
+	return SqexHashPath(std::wstring_view(normalizedPath.native()));
 }
 
 std::string Sqex::Sqpack::EntryPathSpec::DatFile() const {
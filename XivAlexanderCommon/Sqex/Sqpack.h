@@ -365,6 +365,31 @@ namespace Sqex::Sqpack {
 	uint32_t SqexHash(const std::string_view& text);
 	uint32_t SqexHash(const std::filesystem::path& path);
 
+	// Incremental SqexHash; lowercases ASCII and maps '\\' to '/' on the fly, without allocating.
+	class SqexHasher {
+		uint32_t m_state = 0xFFFFFFFFUL;
+
+	public:
+		SqexHasher& Update(const char* data, size_t len);
+		SqexHasher& Update(std::string_view text) { return Update(text.data(), text.size()); }
+
+		// Hashes the UTF-8 representation of the text, as Utils::ToUtf8 would produce it.
+		SqexHasher& Update(std::wstring_view text);
+
+		[[nodiscard]] uint32_t Value() const { return m_state; }
+	};
+
+	struct SqexPathHashes {
+		uint32_t PathHash;
+		uint32_t NameHash;
+		uint32_t FullPathHash;
+	};
+
+	// Hashes of parent path, file name, and full path of a lexically normal path, in one pass.
+	SqexPathHashes SqexHashPath(std::string_view normalizedPath);
+	SqexPathHashes SqexHashPath(std::wstring_view normalizedPath);
+	SqexPathHashes SqexHashPath(const std::filesystem::path& normalizedPath);
+
 	struct EntryPathSpec {
 		static constexpr auto EmptyHashValue = 0xFFFFFFFF;
 
@@ -421,37 +446,42 @@ namespace Sqex::Sqpack {
 
 		EntryPathSpec(const std::filesystem::path& fullPath)
 			: FullPath(fullPath.lexically_normal())
-			, PathHash(SqexHash(FullPath.parent_path()))
-			, NameHash(SqexHash(FullPath.filename()))
-			, FullPathHash(SqexHash(FullPath)) {
+			, PathHash(EmptyHashValue)
+			, NameHash(EmptyHashValue)
+			, FullPathHash(EmptyHashValue) {
+			UpdateHashesFromFullPath();
 		}
 
 		EntryPathSpec(const std::string& fullPath)
 			: FullPath(std::filesystem::path(Utils::FromUtf8(fullPath)).lexically_normal())
-			, PathHash(SqexHash(FullPath.parent_path()))
-			, NameHash(SqexHash(FullPath.filename()))
-			, FullPathHash(SqexHash(FullPath)) {
+			, PathHash(EmptyHashValue)
+			, NameHash(EmptyHashValue)
+			, FullPathHash(EmptyHashValue) {
+			UpdateHashesFromFullPath();
 		}
 
 		EntryPathSpec(const std::wstring& fullPath)
 			: FullPath(std::filesystem::path(fullPath).lexically_normal())
-			, PathHash(SqexHash(FullPath.parent_path()))
-			, NameHash(SqexHash(FullPath.filename()))
-			, FullPathHash(SqexHash(FullPath)) {
+			, PathHash(EmptyHashValue)
+			, NameHash(EmptyHashValue)
+			, FullPathHash(EmptyHashValue) {
+			UpdateHashesFromFullPath();
 		}
 
 		EntryPathSpec(const char* fullPath)
 			: FullPath(std::filesystem::path(Utils::FromUtf8(fullPath)).lexically_normal())
-			, PathHash(SqexHash(FullPath.parent_path()))
-			, NameHash(SqexHash(FullPath.filename()))
-			, FullPathHash(SqexHash(FullPath)) {
+			, PathHash(EmptyHashValue)
+			, NameHash(EmptyHashValue)
+			, FullPathHash(EmptyHashValue) {
+			UpdateHashesFromFullPath();
 		}
 
 		EntryPathSpec(const wchar_t* fullPath)
 			: FullPath(std::filesystem::path(fullPath).lexically_normal())
-			, PathHash(SqexHash(FullPath.parent_path()))
-			, NameHash(SqexHash(FullPath.filename()))
-			, FullPathHash(SqexHash(FullPath)) {
+			, PathHash(EmptyHashValue)
+			, NameHash(EmptyHashValue)
+			, FullPathHash(EmptyHashValue) {
+			UpdateHashesFromFullPath();
 		}
 
 		EntryPathSpec(const std::filesystem::path& path, const std::filesystem::path& name)
@@ -463,18 +493,14 @@ namespace Sqex::Sqpack {
 
 		EntryPathSpec& operator=(const std::filesystem::path& fullPath) {
 			FullPath = fullPath.lexically_normal();
-			PathHash = SqexHash(FullPath.parent_path());
-			NameHash = SqexHash(FullPath.filename());
-			FullPathHash = SqexHash(FullPath);
+			UpdateHashesFromFullPath();
 			return *this;
 		}
 
 		template<class Elem, class Traits = std::char_traits<Elem>, class Alloc = std::allocator<Elem>>
 		EntryPathSpec& operator=(const std::basic_string<Elem, Traits, Alloc>& fullPath) {
 			FullPath = std::filesystem::path(fullPath).lexically_normal();
-			PathHash = SqexHash(FullPath.parent_path());
-			NameHash = SqexHash(FullPath.filename());
-			FullPathHash = SqexHash(FullPath);
+			UpdateHashesFromFullPath();
 			return *this;
 		}
 
@@ -486,6 +512,13 @@ namespace Sqex::Sqpack {
 			return *this;
 		}
 
+		void UpdateHashesFromFullPath() {
+			const auto hashes = SqexHashPath(FullPath);
+			PathHash = hashes.PathHash;
+			NameHash = hashes.NameHash;
+			FullPathHash = hashes.FullPathHash;
+		}
+
 		[[nodiscard]] bool HasFullPathHash() const {
 			return FullPathHash != EmptyHashValue;
 		}
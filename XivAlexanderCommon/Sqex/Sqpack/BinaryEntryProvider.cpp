@@ -1,7 +1,8 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/BinaryEntryProvider.h"
 
-#include "XivAlexanderCommon/Utils/ZlibWrapper.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/BlockCompressor.h"
+#include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
 
 using namespace Sqex;
 using namespace Sqex::Sqpack;
@@ -126,21 +127,36 @@ void Sqex::Sqpack::MemoryBinaryEntryProvider::Initialize(const RandomAccessStrea
 		.BlockCountOrVersion = 0,
 	};
 
-	std::optional<ZlibReusableDeflater> deflater;
-	if (m_compressionLevel)
-		deflater.emplace(m_compressionLevel, Z_DEFLATED, -15);
+	const auto blockAlignment = Align<uint32_t>(rawSize, EntryBlockDataSize);
+	const auto source = stream.ReadStreamIntoVector<uint8_t>(0, rawSize);
+
+	// Blocks are compressed independently of each other, so spread them over worker threads, a few blocks per task.
+	std::vector<std::vector<uint8_t>> compressedBlocks(blockAlignment.Count);
+	if (m_compressionLevel) {
+		constexpr uint32_t BlocksPerTask = 8;
+		Utils::Win32::ParallelFor(Align<uint32_t>(blockAlignment.Count, BlocksPerTask).Count, [&](size_t taskIndex) {
+			const auto compressor = BlockCompressor::CreateNew(m_compressionLevel);
+			const auto from = static_cast<uint32_t>(taskIndex) * BlocksPerTask;
+			const auto to = std::min(from + BlocksPerTask, blockAlignment.Count);
+			blockAlignment.IterateChunkedBreakable([&](uint32_t index, uint32_t offset, uint32_t size) {
+				if (index >= to)
+					return false;
+				const auto compressed = compressor->Compress(std::span(source).subspan(offset, size));
+				if (compressed.size() < size)
+					compressedBlocks[index].assign(compressed.begin(), compressed.end());
+				return true;
+			}, 0, from);
+		});
+	}
+
 	std::vector<uint8_t> entryBody;
 	entryBody.reserve(rawSize);
 
 	std::vector<SqData::BlockHeaderLocator> locators;
-	std::vector<uint8_t> sourceBuf(EntryBlockDataSize);
-	Align<uint32_t>(rawSize, EntryBlockDataSize).IterateChunked([&](uint32_t index, uint32_t offset, uint32_t size) {
-		sourceBuf.resize(size);
-		stream.ReadStream(offset, std::span(sourceBuf));
-		if (deflater)
-			deflater->Deflate(sourceBuf);
-		const auto useCompressed = deflater && deflater->Result().size() < sourceBuf.size();
-		const auto targetBuf = useCompressed ? deflater->Result() : sourceBuf;
+	blockAlignment.IterateChunked([&](uint32_t index, uint32_t offset, uint32_t size) {
+		const auto sourceBuf = std::span(source).subspan(offset, size);
+		const auto useCompressed = !compressedBlocks[index].empty();
+		const auto targetBuf = useCompressed ? std::span<const uint8_t>(compressedBlocks[index]) : sourceBuf;
 
 		SqData::BlockHeader header{
 			.HeaderSize = sizeof SqData::BlockHeader,
@@ -162,6 +178,8 @@ void Sqex::Sqpack::MemoryBinaryEntryProvider::Initialize(const RandomAccessStrea
 		ptr = std::copy_n(reinterpret_cast<uint8_t*>(&header), sizeof header, ptr);
 		ptr = std::copy(targetBuf.begin(), targetBuf.end(), ptr);
 		std::fill_n(ptr, alignmentInfo.Pad, 0);
+
+		std::vector<uint8_t>().swap(compressedBlocks[index]);
 		});
 
 	entryHeader.BlockCountOrVersion = static_cast<uint32_t>(locators.size());
@@ -1,9 +1,196 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/BinaryStreamDecoder.h"
 
+#include <future>
+
 #include "XivAlexanderCommon/Utils/ZlibWrapper.h"
 
-Sqex::Sqpack::BinaryStreamDecoder::BinaryStreamDecoder(const SqData::FileEntryHeader& header, std::shared_ptr<const EntryProvider> stream)
+namespace {
+	// Serves reads that fall inside blocks fetched beforehand in a single batch, and passes through everything else.
+	class PrefetchedBlocksStream : public Sqex::RandomAccessStream {
+		const RandomAccessStream& m_underlying;
+		const std::span<const BatchReadRequest> m_blocks;
+
+	public:
+		PrefetchedBlocksStream(const RandomAccessStream& underlying, std::span<const BatchReadRequest> blocks)
+			: m_underlying(underlying)
+			, m_blocks(blocks) {
+		}
+
+		[[nodiscard]] uint64_t StreamSize() const override {
+			return m_underlying.StreamSize();
+		}
+
+		uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const override {
+			for (const auto& block : m_blocks) {
+				if (block.Offset <= offset && offset < block.Offset + block.Read) {
+					const auto available = std::min(length, block.Offset + block.Read - offset);
+					std::copy_n(static_cast<const uint8_t*>(block.Buffer) + (offset - block.Offset), static_cast<size_t>(available), static_cast<uint8_t*>(buf));
+					return available;
+				}
+			}
+			return m_underlying.ReadStreamPartial(offset, buf, length);
+		}
+	};
+}
+
+class Sqex::Sqpack::BinaryStreamDecoder::ReadAheadQueue {
+	struct DecodeJob {
+		std::shared_ptr<const EntryProvider> Stream;
+		EntryProvider::BackingStreamView Backing;
+		uint32_t BlockOffset{};
+		std::vector<uint8_t> Buffer;
+		std::promise<void> Promise;
+	};
+
+	struct PendingBlock {
+		std::shared_ptr<DecodeJob> Job;
+		std::shared_future<void> Future;
+	};
+
+	const std::shared_ptr<const EntryProvider> m_stream;
+	const EntryProvider::BackingStreamView m_backing;
+	const std::span<const uint32_t> m_blockOffsets;
+	const size_t m_depth;
+
+	std::map<size_t, PendingBlock> m_pending;
+	std::vector<std::vector<uint8_t>> m_freeBuffers;
+
+	static SqData::BlockHeader DecodeBlock(const RandomAccessStream& stream, uint32_t blockOffset, std::vector<uint8_t>& result) {
+		// Pool threads are shared by all decoders, so keep the inflater and the compressed buffer around per thread.
+		thread_local Utils::ZlibReusableInflater inflater{ -MAX_WBITS };
+		thread_local std::vector<uint8_t> compressed;
+
+		const auto blockHeader = stream.ReadStream<SqData::BlockHeader>(blockOffset);
+		result.resize(blockHeader.DecompressedSize);
+		if (blockHeader.CompressedSize == SqData::BlockHeader::CompressedSizeNotCompressed) {
+			stream.ReadStream(blockOffset + sizeof blockHeader, std::span(result));
+
+		} else {
+			compressed.resize(blockHeader.CompressedSize);
+			stream.ReadStream(blockOffset + sizeof blockHeader, std::span(compressed));
+
+			const auto buf = inflater(compressed, result);
+			if (buf.size_bytes() != result.size())
+				throw CorruptDataException(std::format("Expected {} bytes, inflated to {} bytes",
+					result.size(), buf.size_bytes()));
+		}
+		return blockHeader;
+	}
+
+	static void __stdcall Run(PTP_CALLBACK_INSTANCE, void* context) {
+		const auto job = std::move(*std::unique_ptr<std::shared_ptr<DecodeJob>>(static_cast<std::shared_ptr<DecodeJob>*>(context)));
+		try {
+			const auto blockHeader = DecodeBlock(*job->Stream, job->BlockOffset, job->Buffer);
+			if (job->Backing.Stream && blockHeader.CompressedSize != SqData::BlockHeader::CompressedSizeNotCompressed) {
+				auto block = std::make_shared<BlockCache::Block>();
+				block->Header = blockHeader;
+				block->Data = job->Buffer;
+				BlockCache::Instance().Insert(job->Backing.Stream, job->Backing.Offset + job->BlockOffset, std::move(block));
+			}
+			job->Promise.set_value();
+		} catch (...) {
+			job->Promise.set_exception(std::current_exception());
+		}
+	}
+
+	void Recycle(PendingBlock& block) {
+		block.Future.wait();
+		if (m_freeBuffers.size() <= m_depth)
+			m_freeBuffers.emplace_back(std::move(block.Job->Buffer));
+	}
+
+	void Submit(size_t blockIndex) {
+		const auto job = std::make_shared<DecodeJob>();
+		job->Stream = m_stream;
+		job->BlockOffset = m_blockOffsets[blockIndex];
+		if (!m_freeBuffers.empty()) {
+			job->Buffer = std::move(m_freeBuffers.back());
+			m_freeBuffers.pop_back();
+		}
+
+		auto& pending = m_pending[blockIndex];
+		pending.Job = job;
+		pending.Future = job->Promise.get_future().share();
+
+		if (m_backing.Stream) {
+			if (const auto block = BlockCache::Instance().Find(m_backing.Stream, m_backing.Offset + job->BlockOffset)) {
+				job->Buffer.assign(block->Data.begin(), block->Data.end());
+				job->Promise.set_value();
+				return;
+			}
+			job->Backing = m_backing;
+		}
+
+		auto context = std::make_unique<std::shared_ptr<DecodeJob>>(job);
+		if (TrySubmitThreadpoolCallback(&Run, context.get(), nullptr))
+			void(context.release());
+		else
+			Run(nullptr, context.release());
+	}
+
+public:
+	ReadAheadQueue(std::shared_ptr<const EntryProvider> stream, EntryProvider::BackingStreamView backing, std::span<const uint32_t> blockOffsets, size_t depth)
+		: m_stream(std::move(stream))
+		, m_backing(std::move(backing))
+		, m_blockOffsets(blockOffsets)
+		, m_depth(depth) {
+	}
+
+	ReadAheadQueue(ReadAheadQueue&&) = delete;
+	ReadAheadQueue(const ReadAheadQueue&) = delete;
+	ReadAheadQueue& operator=(ReadAheadQueue&&) = delete;
+	ReadAheadQueue& operator=(const ReadAheadQueue&) = delete;
+
+	~ReadAheadQueue() {
+		Clear();
+	}
+
+	[[nodiscard]] bool Has(size_t blockIndex) const {
+		return m_pending.contains(blockIndex);
+	}
+
+	// Queues up to m_depth blocks starting from blockIndex, skipping the ones already queued.
+	void Schedule(size_t blockIndex) {
+		const auto to = std::min(m_blockOffsets.size(), blockIndex + m_depth);
+		for (; blockIndex < to; ++blockIndex) {
+			if (!m_pending.contains(blockIndex))
+				Submit(blockIndex);
+		}
+	}
+
+	// Waits for the block to be decoded. The returned span stays valid until the block gets retired.
+	std::span<const uint8_t> Get(size_t blockIndex) {
+		auto it = m_pending.find(blockIndex);
+		if (it == m_pending.end()) {
+			Submit(blockIndex);
+			it = m_pending.find(blockIndex);
+		}
+
+		try {
+			it->second.Future.get();
+		} catch (...) {
+			m_pending.erase(it);
+			throw;
+		}
+		return it->second.Job->Buffer;
+	}
+
+	void RetireBefore(size_t blockIndex) {
+		while (!m_pending.empty() && m_pending.begin()->first < blockIndex) {
+			Recycle(m_pending.begin()->second);
+			m_pending.erase(m_pending.begin());
+		}
+	}
+
+	void Clear() {
+		for (auto& pending : m_pending | std::views::values)
+			Recycle(pending);
+		m_pending.clear();
+	}
+};
+
+Sqex::Sqpack::BinaryStreamDecoder::BinaryStreamDecoder(const SqData::FileEntryHeader& header, std::shared_ptr<const EntryProvider> stream, size_t readAheadBlockCount)
 	: StreamDecoder(std::move(stream)) {
 	const auto locators = m_stream->ReadStreamIntoVector<SqData::BlockHeaderLocator>(
 		sizeof SqData::FileEntryHeader,
@@ -13,14 +200,20 @@ Sqex::Sqpack::BinaryStreamDecoder::BinaryStreamDecoder(const SqData::FileEntryHe
 	for (const auto& locator : locators) {
 		m_offsets.emplace_back(rawFileOffset);
 		m_blockOffsets.emplace_back(header.HeaderSize + locator.Offset);
+		m_blockSizes.emplace_back(locator.BlockSize);
 		m_maxBlockSize = std::max<size_t>(m_maxBlockSize, locator.BlockSize.Value());
 		rawFileOffset += locator.DecompressedDataSize;
 	}
 
 	if (rawFileOffset < header.DecompressedSize)
 		throw CorruptDataException("Data truncated (sum(BlockHeaderLocator.DecompressedDataSize) < FileEntryHeader.DecompresedSize)");
+
+	if (readAheadBlockCount && m_offsets.size() >= MinimumReadAheadEntryBlockCount)
+		m_readAhead = std::make_unique<ReadAheadQueue>(m_stream, m_backing, m_blockOffsets, readAheadBlockCount);
 }
 
+Sqex::Sqpack::BinaryStreamDecoder::~BinaryStreamDecoder() = default;
+
 uint64_t Sqex::Sqpack::BinaryStreamDecoder::ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) {
 	if (!length)
 		return 0;
@@ -29,12 +222,59 @@ uint64_t Sqex::Sqpack::BinaryStreamDecoder::ReadStreamPartial(uint64_t offset, v
 	if (it && (it == m_offsets.size() || (it != m_offsets.size() && m_offsets[it] > offset)))
 		--it;
 
+	const auto target = std::span(static_cast<uint8_t*>(buf), static_cast<size_t>(length));
+	if (m_readAhead) {
+		// Keep serving from decoded blocks as long as the reader continues where it left off,
+		// or seeks within blocks that are already queued.
+		if (offset == m_lastReadEnd || m_readAhead->Has(it)) {
+			const auto read = ReadStreamPartialFromReadAhead(it, offset, target);
+			m_lastReadEnd = offset + read;
+			return read;
+		}
+		m_readAhead->Clear();
+	}
+
+	if (m_readBuffer.size() < m_maxBlockSize)
+		m_readBuffer.resize(m_maxBlockSize);
+
+	// Fetch every block the read touches and the block cache does not have at once, so that the underlying file gets one read instead of one per block.
+	// The compressed data is only needed during this read, so do not keep the buffer around.
+	std::vector<uint8_t> prefetchBuffer;
+	m_prefetchRequests.clear();
+	if (const auto end = static_cast<size_t>(std::distance(m_offsets.begin(), std::ranges::lower_bound(m_offsets, offset + length))); end - it >= 2) {
+		const auto useCache = !!m_backing.Stream;
+		size_t prefetchSize = 0;
+		for (auto i = it; i < end; ++i) {
+			if (useCache && BlockCache::Instance().Contains(m_backing.Stream, m_backing.Offset + m_blockOffsets[i]))
+				continue;
+			m_prefetchRequests.emplace_back(RandomAccessStream::BatchReadRequest{
+				.Offset = m_blockOffsets[i],
+				.Length = m_blockSizes[i],
+			});
+			prefetchSize += m_blockSizes[i];
+		}
+
+		if (m_prefetchRequests.size() >= 2) {
+			prefetchBuffer.resize(prefetchSize);
+
+			prefetchSize = 0;
+			for (auto& request : m_prefetchRequests) {
+				request.Buffer = &prefetchBuffer[prefetchSize];
+				prefetchSize += static_cast<size_t>(request.Length);
+			}
+			m_stream->ReadStreamPartialBatch(m_prefetchRequests);
+		} else
+			m_prefetchRequests.clear();
+	}
+	const auto prefetched = PrefetchedBlocksStream(*m_stream, m_prefetchRequests);
+
 	ReadStreamState info{
-		.Underlying = *m_stream,
-		.TargetBuffer = std::span(static_cast<uint8_t*>(buf), static_cast<size_t>(length)),
-		.ReadBuffer = std::vector<uint8_t>(m_maxBlockSize),
+		.Underlying = prefetched,
+		.TargetBuffer = target,
+		.ReadBuffer = std::move(m_readBuffer),
 		.RelativeOffset = offset - m_offsets[it],
 		.RequestOffsetVerify = m_offsets[it],
+		.Backing = &m_backing,
 	};
 
 	for (; it < m_offsets.size(); ++it) {
@@ -44,5 +284,41 @@ uint64_t Sqex::Sqpack::BinaryStreamDecoder::ReadStreamPartial(uint64_t offset, v
 	}
 
 	m_maxBlockSize = info.ReadBuffer.size();
-	return length - info.TargetBuffer.size_bytes();
+	m_readBuffer = std::move(info.ReadBuffer);
+
+	const auto read = length - info.TargetBuffer.size_bytes();
+	m_lastReadEnd = offset + read;
+	return read;
+}
+
+uint64_t Sqex::Sqpack::BinaryStreamDecoder::ReadStreamPartialFromReadAhead(size_t blockIndex, uint64_t offset, std::span<uint8_t> target) {
+	const auto requested = target.size_bytes();
+	auto position = offset;
+
+	for (; blockIndex < m_offsets.size() && !target.empty(); ++blockIndex) {
+		m_readAhead->RetireBefore(blockIndex);
+		m_readAhead->Schedule(blockIndex);
+
+		// Blocks that decode to fewer bytes than their locator claims leave a zero-filled gap, same as ReadStreamState::Progress.
+		if (position < m_offsets[blockIndex]) {
+			const auto padding = std::min<size_t>(target.size_bytes(), static_cast<size_t>(m_offsets[blockIndex] - position));
+			std::fill_n(target.begin(), padding, 0);
+			target = target.subspan(padding);
+			position += padding;
+			if (target.empty())
+				break;
+		}
+
+		const auto block = m_readAhead->Get(blockIndex);
+		const auto relativeOffset = static_cast<size_t>(position - m_offsets[blockIndex]);
+		if (relativeOffset >= block.size())
+			continue;
+
+		const auto available = std::min(target.size_bytes(), block.size() - relativeOffset);
+		std::copy_n(&block[relativeOffset], available, target.begin());
+		target = target.subspan(available);
+		position += available;
+	}
+
+	return requested - target.size_bytes();
 }
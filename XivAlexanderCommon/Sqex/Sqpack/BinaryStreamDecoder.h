@@ -6,9 +6,27 @@ namespace Sqex::Sqpack {
 	class BinaryStreamDecoder : public StreamDecoder {
 		std::vector<uint32_t> m_offsets;
 		std::vector<uint32_t> m_blockOffsets;
+		std::vector<uint16_t> m_blockSizes;
+		std::vector<uint8_t> m_readBuffer;
+		std::vector<RandomAccessStream::BatchReadRequest> m_prefetchRequests;
+
+		class ReadAheadQueue;
+		std::unique_ptr<ReadAheadQueue> m_readAhead;
+		uint64_t m_lastReadEnd = UINT64_MAX;
 
 	public:
-		BinaryStreamDecoder(const SqData::FileEntryHeader& header, std::shared_ptr<const EntryProvider> stream);
+		// Number of blocks decoded ahead of the reader on the thread pool, once reads turn out to be sequential.
+		static constexpr size_t DefaultReadAheadBlockCount = 4;
+
+		// Entries spanning fewer blocks than this are decoded synchronously, as prefetching would not pay for itself.
+		static constexpr size_t MinimumReadAheadEntryBlockCount = 8;
+
+		BinaryStreamDecoder(const SqData::FileEntryHeader& header, std::shared_ptr<const EntryProvider> stream, size_t readAheadBlockCount = DefaultReadAheadBlockCount);
+		~BinaryStreamDecoder() override;
+
 		uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) override;
+
+	private:
+		uint64_t ReadStreamPartialFromReadAhead(size_t blockIndex, uint64_t offset, std::span<uint8_t> target);
 	};
 }
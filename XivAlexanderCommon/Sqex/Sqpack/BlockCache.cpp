@@ -0,0 +1,116 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/BlockCache.h"
+
+Sqex::Sqpack::BlockCache::BlockCache(uint64_t capacity)
+	: m_capacity(capacity) {
+}
+
+Sqex::Sqpack::BlockCache& Sqex::Sqpack::BlockCache::Instance() {
+	static BlockCache s_instance;
+	return s_instance;
+}
+
+void Sqex::Sqpack::BlockCache::Erase(Shard& shard, std::list<Item>::iterator it) {
+	shard.ByteCount -= it->Value->Data.size();
+	shard.Index.erase(it->Id);
+	shard.Items.erase(it);
+}
+
+void Sqex::Sqpack::BlockCache::Trim(Shard& shard) {
+	const auto capacity = m_capacity.load() / ShardCount;
+	while (!shard.Items.empty() && shard.ByteCount > capacity) {
+		Erase(shard, std::prev(shard.Items.end()));
+		++m_evictions;
+	}
+}
+
+std::shared_ptr<const Sqex::Sqpack::BlockCache::Block> Sqex::Sqpack::BlockCache::Find(const std::shared_ptr<const RandomAccessStream>& stream, uint64_t offset) {
+	const auto key = Key{ stream.get(), offset };
+	auto& shard = ShardOf(key);
+
+	const auto lock = std::lock_guard(shard.Mtx);
+	const auto found = shard.Index.find(key);
+	if (found == shard.Index.end()) {
+		++m_misses;
+		return nullptr;
+	}
+
+	const auto it = found->second;
+	if (it->Owner.owner_before(stream) || stream.owner_before(it->Owner)) {
+		Erase(shard, it);
+		++m_misses;
+		return nullptr;
+	}
+
+	shard.Items.splice(shard.Items.begin(), shard.Items, it);
+	++m_hits;
+	return it->Value;
+}
+
+bool Sqex::Sqpack::BlockCache::Contains(const std::shared_ptr<const RandomAccessStream>& stream, uint64_t offset) {
+	const auto key = Key{ stream.get(), offset };
+	auto& shard = ShardOf(key);
+
+	const auto lock = std::lock_guard(shard.Mtx);
+	const auto found = shard.Index.find(key);
+	if (found == shard.Index.end())
+		return false;
+
+	const auto& owner = found->second->Owner;
+	return !owner.owner_before(stream) && !stream.owner_before(owner);
+}
+
+void Sqex::Sqpack::BlockCache::Insert(const std::shared_ptr<const RandomAccessStream>& stream, uint64_t offset, std::shared_ptr<const Block> block) {
+	if (block->Data.size() > m_capacity.load() / ShardCount)
+		return;
+
+	const auto key = Key{ stream.get(), offset };
+	auto& shard = ShardOf(key);
+
+	const auto lock = std::lock_guard(shard.Mtx);
+	if (const auto found = shard.Index.find(key); found != shard.Index.end())
+		Erase(shard, found->second);
+
+	shard.ByteCount += block->Data.size();
+	shard.Items.emplace_front(Item{
+		.Id = key,
+		.Owner = stream,
+		.Value = std::move(block),
+	});
+	shard.Index.emplace(key, shard.Items.begin());
+	Trim(shard);
+}
+
+void Sqex::Sqpack::BlockCache::SetCapacity(uint64_t capacity) {
+	m_capacity = capacity;
+	for (auto& shard : m_shards) {
+		const auto lock = std::lock_guard(shard.Mtx);
+		Trim(shard);
+	}
+}
+
+void Sqex::Sqpack::BlockCache::Clear() {
+	for (auto& shard : m_shards) {
+		const auto lock = std::lock_guard(shard.Mtx);
+		shard.Index.clear();
+		shard.Items.clear();
+		shard.ByteCount = 0;
+	}
+}
+
+Sqex::Sqpack::BlockCache::Statistics Sqex::Sqpack::BlockCache::GetStatistics() {
+	auto result = Statistics{
+		.Hits = m_hits,
+		.Misses = m_misses,
+		.Evictions = m_evictions,
+		.BlockCount = 0,
+		.ByteCount = 0,
+		.Capacity = m_capacity,
+	};
+	for (auto& shard : m_shards) {
+		const auto lock = std::lock_guard(shard.Mtx);
+		result.BlockCount += shard.Items.size();
+		result.ByteCount += shard.ByteCount;
+	}
+	return result;
+}
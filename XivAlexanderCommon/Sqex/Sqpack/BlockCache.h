@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "XivAlexanderCommon/Sqex/Sqpack.h"
+
+namespace Sqex::Sqpack {
+	/*
+	 * Process-wide cache of inflated sqpack blocks, keyed by the backing stream (usually a .dat file) and the block offset in it.
+	 * Split into independently locked shards, each evicting its least recently used blocks once over its share of the capacity.
+	 * Entries keep a weak reference to their stream, so a stream allocated at the address of a destroyed one never gets stale hits.
+	 */
+	class BlockCache {
+	public:
+		struct Block {
+			SqData::BlockHeader Header;
+			std::vector<uint8_t> Data;
+		};
+
+		struct Statistics {
+			uint64_t Hits;
+			uint64_t Misses;
+			uint64_t Evictions;
+			uint64_t BlockCount;
+			uint64_t ByteCount;
+			uint64_t Capacity;
+		};
+
+		static constexpr size_t ShardCount = 16;
+		static constexpr uint64_t DefaultCapacity = 64 * 1048576;
+
+	private:
+		struct Key {
+			const RandomAccessStream* Stream;
+			uint64_t Offset;
+
+			bool operator==(const Key&) const = default;
+		};
+
+		struct KeyHash {
+			size_t operator()(const Key& key) const {
+				return std::hash<const void*>()(key.Stream) ^ std::hash<uint64_t>()(key.Offset * 0x9E3779B97F4A7C15ULL);
+			}
+		};
+
+		struct Item {
+			Key Id;
+			std::weak_ptr<const RandomAccessStream> Owner;
+			std::shared_ptr<const Block> Value;
+		};
+
+		struct Shard {
+			std::mutex Mtx;
+			std::list<Item> Items;  // most recently used first
+			std::unordered_map<Key, std::list<Item>::iterator, KeyHash> Index;
+			uint64_t ByteCount = 0;
+		};
+
+		std::array<Shard, ShardCount> m_shards;
+		std::atomic<uint64_t> m_capacity;
+		std::atomic<uint64_t> m_hits = 0;
+		std::atomic<uint64_t> m_misses = 0;
+		std::atomic<uint64_t> m_evictions = 0;
+
+		Shard& ShardOf(const Key& key) {
+			return m_shards[KeyHash()(key) % ShardCount];
+		}
+
+		void Erase(Shard& shard, std::list<Item>::iterator it);
+		void Trim(Shard& shard);
+
+	public:
+		BlockCache(uint64_t capacity = DefaultCapacity);
+
+		static BlockCache& Instance();
+
+		[[nodiscard]] std::shared_ptr<const Block> Find(const std::shared_ptr<const RandomAccessStream>& stream, uint64_t offset);
+		void Insert(const std::shared_ptr<const RandomAccessStream>& stream, uint64_t offset, std::shared_ptr<const Block> block);
+
+		// Tells whether Find would hit, without counting towards statistics or refreshing the block.
+		[[nodiscard]] bool Contains(const std::shared_ptr<const RandomAccessStream>& stream, uint64_t offset);
+
+		// Setting the capacity to 0 disables caching.
+		void SetCapacity(uint64_t capacity);
+		void Clear();
+
+		[[nodiscard]] Statistics GetStatistics();
+	};
+}
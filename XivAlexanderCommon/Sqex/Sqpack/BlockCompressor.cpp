@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/BlockCompressor.h"
+
+#ifdef XIVALEXANDER_SQPACK_USE_LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
+#include "XivAlexanderCommon/Utils/ZlibWrapper.h"
+
+namespace {
+	class ZlibBlockCompressor : public Sqex::Sqpack::BlockCompressor {
+		Utils::ZlibReusableDeflater m_deflater;
+
+	public:
+		ZlibBlockCompressor(int level)
+			: m_deflater(level == Z_DEFAULT_COMPRESSION ? level : std::clamp(level, Z_BEST_SPEED, Z_BEST_COMPRESSION), Z_DEFLATED, -MAX_WBITS) {
+		}
+
+		std::span<const uint8_t> Compress(std::span<const uint8_t> source) override {
+			return m_deflater.Deflate(source);
+		}
+	};
+
+#ifdef XIVALEXANDER_SQPACK_USE_LIBDEFLATE
+	class LibdeflateBlockCompressor : public Sqex::Sqpack::BlockCompressor {
+		const std::unique_ptr<libdeflate_compressor, decltype(&libdeflate_free_compressor)> m_compressor;
+		std::vector<uint8_t> m_buffer;
+
+	public:
+		LibdeflateBlockCompressor(int level)
+			: m_compressor(libdeflate_alloc_compressor(level == Z_DEFAULT_COMPRESSION ? 6 : std::clamp(level, 1, 12)), &libdeflate_free_compressor) {
+			if (!m_compressor)
+				throw std::bad_alloc();
+		}
+
+		std::span<const uint8_t> Compress(std::span<const uint8_t> source) override {
+			m_buffer.resize(libdeflate_deflate_compress_bound(m_compressor.get(), source.size_bytes()));
+			const auto size = libdeflate_deflate_compress(m_compressor.get(), source.data(), source.size_bytes(), m_buffer.data(), m_buffer.size());
+			if (!size)
+				throw std::runtime_error("libdeflate_deflate_compress failed");
+			return std::span(m_buffer).subspan(0, size);
+		}
+	};
+#endif
+}
+
+std::unique_ptr<Sqex::Sqpack::BlockCompressor> Sqex::Sqpack::BlockCompressor::CreateNew(int level) {
+#ifdef XIVALEXANDER_SQPACK_USE_LIBDEFLATE
+	return std::make_unique<LibdeflateBlockCompressor>(level);
+#else
+	return std::make_unique<ZlibBlockCompressor>(level);
+#endif
+}
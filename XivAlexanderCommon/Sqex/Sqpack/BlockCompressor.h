@@ -0,0 +1,23 @@
+#pragma once
+
+#include <memory>
+#include <span>
+
+namespace Sqex::Sqpack {
+	/*
+	 * Compresses sqpack blocks into raw deflate streams, as expected by SqData::BlockHeader.
+	 * zlib is used unless XIVALEXANDER_SQPACK_USE_LIBDEFLATE is defined at build time, in which case libdeflate is used instead.
+	 * zlib-ng in zlib compatible mode needs no switch here; linking against it in place of zlib is enough.
+	 * An instance is not thread safe; use one per thread.
+	 */
+	class BlockCompressor {
+	public:
+		virtual ~BlockCompressor() = default;
+
+		// Returned span stays valid until the next call. It may be longer than source if source is incompressible.
+		virtual std::span<const uint8_t> Compress(std::span<const uint8_t> source) = 0;
+
+		// level goes from 1 (fastest) to 9 (smallest) for zlib, and up to 12 for libdeflate; out of range values other than Z_DEFAULT_COMPRESSION get clamped.
+		static std::unique_ptr<BlockCompressor> CreateNew(int level);
+	};
+}
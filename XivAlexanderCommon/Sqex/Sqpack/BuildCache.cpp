@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/BuildCache.h"
+
+#include "XivAlexanderCommon/Utils/Utils.h"
+#include "XivAlexanderCommon/Utils/Win32/Handle.h"
+
+static std::string Sha1ToHex(const Sqex::Sqpack::Sha1Value& value) {
+	static constexpr char Digits[] = "0123456789abcdef";
+	std::string result;
+	result.reserve(sizeof value.Value * 2);
+	for (const auto c : value.Value) {
+		result += Digits[static_cast<uint8_t>(c) >> 4];
+		result += Digits[static_cast<uint8_t>(c) & 0xF];
+	}
+	return result;
+}
+
+static Sqex::Sqpack::Sha1Value Sha1FromHex(const std::string& hex) {
+	if (hex.size() != sizeof Sqex::Sqpack::Sha1Value::Value * 2)
+		throw std::invalid_argument("Invalid SHA-1 string");
+
+	Sqex::Sqpack::Sha1Value result;
+	for (size_t i = 0; i < sizeof result.Value; ++i)
+		result.Value[i] = static_cast<char>(std::stoi(hex.substr(i * 2, 2), nullptr, 16));
+	return result;
+}
+
+Sqex::Sqpack::BuildCache::Fingerprint Sqex::Sqpack::BuildCache::Fingerprint::FromFile(const std::filesystem::path& path) {
+	const auto file = Utils::Win32::Handle::FromCreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0);
+
+	Fingerprint result{
+		.Size = file.GetFileSize(),
+		.LastWriteTime = std::filesystem::last_write_time(path).time_since_epoch().count(),
+	};
+
+	static_assert(CryptoPP::SHA1::DIGESTSIZE == sizeof result.Hash.Value);
+	CryptoPP::SHA1 sha1;
+	std::vector<uint8_t> buf(static_cast<size_t>(std::min<uint64_t>(result.Size, HashChunkSize)));
+	for (uint64_t offset = 0; offset < result.Size; offset += buf.size()) {
+		const auto chunk = std::span(buf).subspan(0, static_cast<size_t>(std::min<uint64_t>(buf.size(), result.Size - offset)));
+		file.Read(offset, chunk);
+		sha1.Update(chunk.data(), chunk.size());
+	}
+	sha1.Final(reinterpret_cast<byte*>(result.Hash.Value));
+	return result;
+}
+
+bool Sqex::Sqpack::BuildCache::Fingerprint::operator==(const Fingerprint& r) const {
+	return Size == r.Size && LastWriteTime == r.LastWriteTime && Hash == r.Hash;
+}
+
+Sqex::Sqpack::BuildCache::BuildCache(std::filesystem::path path)
+	: m_path(std::move(path)) {
+	if (!exists(m_path))
+		return;
+
+	try {
+		const auto manifest = Utils::ParseJsonFromFile(m_path, ManifestSizeMax);
+		if (manifest.at("version").get<uint32_t>() != Version)
+			return;
+
+		for (const auto& recordJson : manifest.at("records")) {
+			auto& record = m_records[recordJson.at("source").get<std::filesystem::path>()];
+			for (const auto& input : recordJson.at("inputs")) {
+				record.Inputs.emplace_back(input.at("path").get<std::filesystem::path>(), Fingerprint{
+					.Size = input.at("size").get<uint64_t>(),
+					.LastWriteTime = input.at("lastWriteTime").get<int64_t>(),
+					.Hash = Sha1FromHex(input.at("sha1").get<std::string>()),
+				});
+			}
+			for (const auto& [datName, reservationsJson] : recordJson.at("reservations").items()) {
+				auto& reservations = record.Reservations[datName];
+				for (const auto& reservation : reservationsJson) {
+					reservations.emplace_back(Reservation{
+						.FullPath = reservation.at(0).get<std::string>(),
+						.Size = reservation.at(1).get<uint32_t>(),
+					});
+				}
+			}
+		}
+	} catch (const std::exception&) {
+		m_records.clear();
+	}
+}
+
+std::vector<Sqex::Sqpack::BuildCache::Fingerprint> Sqex::Sqpack::BuildCache::FingerprintsOf(std::span<const std::filesystem::path> paths) {
+	std::vector<Fingerprint> result;
+	result.reserve(paths.size());
+	for (const auto& path : paths) {
+		{
+			const auto lock = std::lock_guard(m_mtx);
+			if (const auto it = m_fingerprints.find(path); it != m_fingerprints.end()) {
+				result.emplace_back(it->second);
+				continue;
+			}
+		}
+
+		// Hash outside the lock, so that other sources can be looked up meanwhile.
+		auto fingerprint = Fingerprint::FromFile(path);
+
+		const auto lock = std::lock_guard(m_mtx);
+		result.emplace_back(m_fingerprints.emplace(path, std::move(fingerprint)).first->second);
+	}
+	return result;
+}
+
+Sqex::Sqpack::BuildCache::Record& Sqex::Sqpack::BuildCache::ValidatedRecord(std::span<const std::filesystem::path> inputs, std::span<const Fingerprint> fingerprints) {
+	if (inputs.empty())
+		throw std::invalid_argument("inputs must not be empty");
+
+	auto& record = m_records[inputs[0]];
+	record.Used = true;
+	if (record.Validated)
+		return record;
+
+	auto valid = record.Inputs.size() == inputs.size();
+	for (size_t i = 0; valid && i < inputs.size(); ++i)
+		valid = record.Inputs[i].first == inputs[i] && record.Inputs[i].second == fingerprints[i];
+
+	if (!valid) {
+		record.Inputs.clear();
+		for (size_t i = 0; i < inputs.size(); ++i)
+			record.Inputs.emplace_back(inputs[i], fingerprints[i]);
+		record.Reservations.clear();
+		m_dirty = true;
+	}
+	record.Validated = true;
+	return record;
+}
+
+std::optional<std::vector<Sqex::Sqpack::BuildCache::Reservation>> Sqex::Sqpack::BuildCache::FindReservations(std::span<const std::filesystem::path> inputs, const std::string& datName) {
+	const auto fingerprints = FingerprintsOf(inputs);
+
+	const auto lock = std::lock_guard(m_mtx);
+	const auto& record = ValidatedRecord(inputs, fingerprints);
+	if (const auto it = record.Reservations.find(datName); it != record.Reservations.end())
+		return it->second;
+	return std::nullopt;
+}
+
+void Sqex::Sqpack::BuildCache::StoreReservations(std::span<const std::filesystem::path> inputs, const std::string& datName, std::vector<Reservation> reservations) {
+	const auto fingerprints = FingerprintsOf(inputs);
+
+	const auto lock = std::lock_guard(m_mtx);
+	ValidatedRecord(inputs, fingerprints).Reservations.insert_or_assign(datName, std::move(reservations));
+	m_dirty = true;
+}
+
+void Sqex::Sqpack::BuildCache::Save() {
+	const auto lock = std::lock_guard(m_mtx);
+
+	for (auto it = m_records.begin(); it != m_records.end();) {
+		if (it->second.Used)
+			++it;
+		else {
+			it = m_records.erase(it);
+			m_dirty = true;
+		}
+	}
+	if (!m_dirty)
+		return;
+
+	auto records = nlohmann::json::array();
+	for (const auto& [source, record] : m_records) {
+		auto inputs = nlohmann::json::array();
+		for (const auto& [path, fingerprint] : record.Inputs) {
+			inputs.emplace_back(nlohmann::json::object({
+				{"path", path},
+				{"size", fingerprint.Size},
+				{"lastWriteTime", fingerprint.LastWriteTime},
+				{"sha1", Sha1ToHex(fingerprint.Hash)},
+			}));
+		}
+
+		auto reservationsJson = nlohmann::json::object();
+		for (const auto& [datName, reservations] : record.Reservations) {
+			auto& arr = reservationsJson[datName] = nlohmann::json::array();
+			for (const auto& reservation : reservations)
+				arr.emplace_back(nlohmann::json::array({reservation.FullPath, reservation.Size}));
+		}
+
+		records.emplace_back(nlohmann::json::object({
+			{"source", source},
+			{"inputs", std::move(inputs)},
+			{"reservations", std::move(reservationsJson)},
+		}));
+	}
+
+	create_directories(m_path.parent_path());
+	Utils::SaveJsonToFile(m_path, nlohmann::json::object({
+		{"version", Version},
+		{"records", std::move(records)},
+	}));
+	m_dirty = false;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include "XivAlexanderCommon/Sqex/Sqpack.h"
+
+namespace Sqex::Sqpack {
+	/*
+	 * Persistent manifest of what Creator derived from its source files on previous runs, so that unchanged sources need not be parsed again.
+	 * Each record is keyed by its primary source path, and is valid only while every file it was derived from keeps the same fingerprint.
+	 * Records of sources that were not looked up during a run are dropped on Save.
+	 */
+	class BuildCache {
+	public:
+		static constexpr uint32_t Version = 2;
+
+		// Files are hashed in full, this many bytes at a time.
+		static constexpr size_t HashChunkSize = 4 * 1048576;
+
+		static constexpr size_t ManifestSizeMax = 256 * 1048576;
+
+		struct Fingerprint {
+			uint64_t Size{};
+			int64_t LastWriteTime{};
+			Sha1Value Hash{};
+
+			static Fingerprint FromFile(const std::filesystem::path& path);
+
+			bool operator==(const Fingerprint& r) const;
+		};
+
+		struct Reservation {
+			std::string FullPath;
+			uint32_t Size{};
+		};
+
+	private:
+		struct Record {
+			std::vector<std::pair<std::filesystem::path, Fingerprint>> Inputs;
+			std::map<std::string, std::vector<Reservation>> Reservations;
+			bool Validated = false;
+			bool Used = false;
+		};
+
+		const std::filesystem::path m_path;
+
+		std::mutex m_mtx;
+		std::map<std::filesystem::path, Record> m_records;
+		std::map<std::filesystem::path, Fingerprint> m_fingerprints;  // computed during this run
+		bool m_dirty = false;
+
+		// Must be called without holding m_mtx, as hashing a file can take a while.
+		std::vector<Fingerprint> FingerprintsOf(std::span<const std::filesystem::path> paths);
+		Record& ValidatedRecord(std::span<const std::filesystem::path> inputs, std::span<const Fingerprint> fingerprints);
+
+	public:
+		// Loads the manifest at path if there is a usable one; an unreadable manifest is treated as empty.
+		BuildCache(std::filesystem::path path);
+
+		// inputs[0] identifies the record; the rest are other files the result was derived from.
+		[[nodiscard]] std::optional<std::vector<Reservation>> FindReservations(std::span<const std::filesystem::path> inputs, const std::string& datName);
+		void StoreReservations(std::span<const std::filesystem::path> inputs, const std::string& datName, std::vector<Reservation> reservations);
+
+		void Save();
+	};
+}
@@ -1,8 +1,11 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/Creator.h"
 
+#include <future>
+
 #include "XivAlexanderCommon/Sqex/Model.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/BinaryEntryProvider.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/BuildCache.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/EmptyOrObfuscatedEntryProvider.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/EntryRawStream.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/HotSwappableEntryProvider.h"
@@ -11,6 +14,7 @@
 #include "XivAlexanderCommon/Sqex/Sqpack/Reader.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/TextureEntryProvider.h"
 #include "XivAlexanderCommon/Sqex/ThirdParty/TexTools.h"
+#include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
 
 struct Sqex::Sqpack::Creator::Implementation {
 	void AddEntry(AddEntryResult& result, std::shared_ptr<EntryProvider> provider, bool overwriteExisting = true);
@@ -195,49 +199,54 @@ Sqex::Sqpack::Creator::AddEntryResult Sqex::Sqpack::Creator::AddAllEntriesFromSi
 	return result;
 }
 
-void Sqex::Sqpack::Creator::ReserveSpacesFromTTMP(const ThirdParty::TexTools::TTMPL & ttmpl, const std::shared_ptr<Sqex::RandomAccessStream>&ttmpd) {
-	for (const auto& entry : ttmpl.SimpleModsList) {
-		if (entry.DatFile != DatName || entry.ModSize > UINT32_MAX)
-			continue;
+static std::vector<Sqex::Sqpack::BuildCache::Reservation> CollectReservationsFromTTMP(const std::string& datName, const Sqex::ThirdParty::TexTools::TTMPL& ttmpl, const std::shared_ptr<Sqex::RandomAccessStream>& ttmpd) {
+	std::vector<Sqex::Sqpack::BuildCache::Reservation> result;
+	const auto collect = [&](const Sqex::ThirdParty::TexTools::ModEntry& entry) {
+		if (entry.DatFile != datName || entry.ModSize > UINT32_MAX)
+			return;
 
 		if (entry.IsMetadata()) {
 			const auto metadata = Sqex::ThirdParty::TexTools::ItemMetadata(entry.FullPath, Sqex::Sqpack::EntryRawStream(std::make_shared<Sqex::Sqpack::RandomAccessStreamAsEntryProviderView>(entry.FullPath, ttmpd, entry.ModOffset, entry.ModSize)));
 			if (!metadata.Get<Sqex::Imc::Entry>(Sqex::ThirdParty::TexTools::ItemMetadata::MetaDataType::Imc).empty())
-				ReserveSwappableSpace(metadata.TargetImcPath, 65536);
+				result.emplace_back(metadata.TargetImcPath, 65536);
 			if (const auto eqdpedit = metadata.Get<Sqex::ThirdParty::TexTools::ItemMetadata::EqdpEntry>(Sqex::ThirdParty::TexTools::ItemMetadata::MetaDataType::Eqdp); !eqdpedit.empty()) {
 				for (const auto& v : eqdpedit) {
-					ReserveSwappableSpace(metadata.EqdpPath(metadata.ItemType, v.RaceCode), 1048576);
+					result.emplace_back(metadata.EqdpPath(metadata.ItemType, v.RaceCode), 1048576);
 				}
 			}
-			continue;
+			return;
 		}
 
-		ReserveSwappableSpace(entry.FullPath, static_cast<uint32_t>(entry.ModSize));
-	}
+		result.emplace_back(entry.FullPath, static_cast<uint32_t>(entry.ModSize));
+	};
+
+	for (const auto& entry : ttmpl.SimpleModsList)
+		collect(entry);
 	for (const auto& modPackPage : ttmpl.ModPackPages) {
 		for (const auto& modGroup : modPackPage.ModGroups) {
 			for (const auto& option : modGroup.OptionList) {
-				for (const auto& entry : option.ModsJsons) {
-					if (entry.DatFile != DatName || entry.ModSize > UINT32_MAX)
-						continue;
-
-					if (entry.IsMetadata()) {
-						const auto metadata = Sqex::ThirdParty::TexTools::ItemMetadata(entry.FullPath, Sqex::Sqpack::EntryRawStream(std::make_shared<Sqex::Sqpack::RandomAccessStreamAsEntryProviderView>(entry.FullPath, ttmpd, entry.ModOffset, entry.ModSize)));
-						if (!metadata.Get<Sqex::Imc::Entry>(Sqex::ThirdParty::TexTools::ItemMetadata::MetaDataType::Imc).empty())
-							ReserveSwappableSpace(metadata.TargetImcPath, 65536);
-						if (const auto eqdpedit = metadata.Get<Sqex::ThirdParty::TexTools::ItemMetadata::EqdpEntry>(Sqex::ThirdParty::TexTools::ItemMetadata::MetaDataType::Eqdp); !eqdpedit.empty()) {
-							for (const auto& v : eqdpedit) {
-								ReserveSwappableSpace(metadata.EqdpPath(metadata.ItemType, v.RaceCode), 1048576);
-							}
-						}
-						continue;
-					}
-
-					ReserveSwappableSpace(entry.FullPath, static_cast<uint32_t>(entry.ModSize));
-				}
+				for (const auto& entry : option.ModsJsons)
+					collect(entry);
 			}
 		}
 	}
+	return result;
+}
+
+void Sqex::Sqpack::Creator::ReserveSpacesFromTTMP(const ThirdParty::TexTools::TTMPL & ttmpl, const std::shared_ptr<Sqex::RandomAccessStream>&ttmpd) {
+	for (const auto& reservation : CollectReservationsFromTTMP(DatName, ttmpl, ttmpd))
+		ReserveSwappableSpace(reservation.FullPath, reservation.Size);
+}
+
+void Sqex::Sqpack::Creator::ReserveSpacesFromTTMP(const ThirdParty::TexTools::TTMPL& ttmpl, const std::shared_ptr<Sqex::RandomAccessStream>& ttmpd, BuildCache& cache, const std::filesystem::path& ttmplPath, const std::filesystem::path& ttmpdPath) {
+	const std::filesystem::path inputs[]{ ttmplPath, ttmpdPath };
+	auto reservations = cache.FindReservations(inputs, DatName);
+	if (!reservations) {
+		reservations = CollectReservationsFromTTMP(DatName, ttmpl, ttmpd);
+		cache.StoreReservations(inputs, DatName, *reservations);
+	}
+	for (const auto& reservation : *reservations)
+		ReserveSwappableSpace(reservation.FullPath, reservation.Size);
 }
 
 Sqex::Sqpack::Creator::AddEntryResult Sqex::Sqpack::Creator::AddEntry(std::shared_ptr<EntryProvider> provider, bool overwriteExisting) {
@@ -247,6 +256,7 @@ Sqex::Sqpack::Creator::AddEntryResult Sqex::Sqpack::Creator::AddEntry(std::share
 void Sqex::Sqpack::Creator::ReserveSwappableSpace(EntryPathSpec pathSpec, uint32_t size) {
 	if (const auto it = m_pImpl->m_hashOnlyEntries.find(pathSpec); it != m_pImpl->m_hashOnlyEntries.end()) {
 		it->second->EntrySize = std::max(it->second->EntrySize, size);
+		it->second->Reserved = true;
 		if (!it->second->Provider->PathSpec().HasOriginal() && pathSpec.HasOriginal()) {
 			it->second->Provider->UpdatePathSpec(pathSpec);
 			m_pImpl->m_fullEntries.emplace(pathSpec, std::move(it->second));
@@ -254,8 +264,9 @@ void Sqex::Sqpack::Creator::ReserveSwappableSpace(EntryPathSpec pathSpec, uint32
 		}
 	} else if (const auto it = m_pImpl->m_fullEntries.find(pathSpec); it != m_pImpl->m_fullEntries.end()) {
 		it->second->EntrySize = std::max(it->second->EntrySize, size);
+		it->second->Reserved = true;
 	} else {
-		auto entry = std::make_unique<Entry>(size, SqIndex::LEDataLocator{ 0, 0 }, std::make_shared<EmptyOrObfuscatedEntryProvider>(std::move(pathSpec)));
+		auto entry = std::make_unique<Entry>(size, SqIndex::LEDataLocator{ 0, 0 }, std::make_shared<EmptyOrObfuscatedEntryProvider>(std::move(pathSpec)), true);
 		if (entry->Provider->PathSpec().HasOriginal())
 			m_pImpl->m_fullEntries.emplace(entry->Provider->PathSpec(), std::move(entry));
 		else
@@ -383,6 +394,11 @@ public:
 		, m_buffer(std::move(buffer)) {
 	}
 
+	~DataView() override {
+		if (m_buffer)
+			m_buffer->Forget(this);
+	}
+
 	uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const override {
 		const auto st = Utils::QpcUs();
 		m_pLastEntryProviders.clear();
@@ -428,12 +444,10 @@ public:
 				const auto& entry = **it;
 				m_lastAccessedEntryIndex = it - m_entries.begin();
 
-				const auto buf = m_buffer ? m_buffer->GetBuffer(this, &entry) : nullptr;
-
 				if (relativeOffset < entry.EntrySize) {
 					const auto available = std::min(out.size_bytes(), static_cast<size_t>(entry.EntrySize - relativeOffset));
 					m_pLastEntryProviders.emplace_back(std::make_tuple(entry.Provider.get(), relativeOffset, available));
-					if (buf)
+					if (const auto buf = m_buffer ? m_buffer->GetBuffer(this, &entry) : nullptr)
 						std::copy_n(&buf->Buffer()[static_cast<size_t>(relativeOffset)], available, &out[0]);
 					else
 						entry.Provider->ReadStream(relativeOffset, out.data(), available);
@@ -469,7 +483,179 @@ public:
 	}
 };
 
-Sqex::Sqpack::Creator::SqpackViews Sqex::Sqpack::Creator::AsViews(bool strict, const std::shared_ptr<SqpackViewEntryCache>&dataBuffer) {
+// Computes SHA-1 of concatenated entries, reading in large chunks and hashing each chunk while the next one is being read.
+static void HashEntries(Sqex::Sqpack::Sha1Value& digest, std::span<Sqex::Sqpack::Creator::Entry* const> entries) {
+	constexpr size_t ChunkSize = 1048576;
+
+	CryptoPP::SHA1 sha1;
+	std::vector<uint8_t> buffers[2]{ std::vector<uint8_t>(ChunkSize), std::vector<uint8_t>(ChunkSize) };
+	size_t active = 0;
+	size_t filled = 0;
+	std::future<void> hashing;
+
+	const auto submit = [&]() {
+		if (hashing.valid())
+			hashing.get();
+		hashing = std::async(std::launch::async, [&sha1, &buf = buffers[active], filled]() {
+			sha1.Update(buf.data(), filled);
+		});
+		active ^= 1;
+		filled = 0;
+	};
+
+	for (const auto& entry : entries) {
+		const auto& provider = *entry->Provider;
+		const auto length = provider.StreamSize();
+		for (uint64_t offset = 0; offset < length;) {
+			const auto readlen = static_cast<size_t>(std::min<uint64_t>(ChunkSize - filled, length - offset));
+			provider.ReadStream(offset, &buffers[active][filled], readlen);
+			filled += readlen;
+			offset += readlen;
+			if (filled == ChunkSize)
+				submit();
+		}
+	}
+	if (filled)
+		submit();
+	if (hashing.valid())
+		hashing.get();
+
+	sha1.Final(reinterpret_cast<byte*>(digest.Value));
+}
+
+// Decoded size of an entry, or nothing if it is not of a type that can be decoded.
+static std::optional<uint64_t> DecodedEntrySize(const Sqex::Sqpack::EntryProvider& provider) {
+	using Sqex::Sqpack::SqData::FileEntryType;
+	if (const auto type = provider.EntryType(); type != FileEntryType::Binary && type != FileEntryType::Model && type != FileEntryType::Texture)
+		return std::nullopt;
+	if (provider.StreamSize() < sizeof Sqex::Sqpack::SqData::FileEntryHeader)
+		return std::nullopt;
+
+	Sqex::Sqpack::SqData::FileEntryHeader header;
+	provider.ReadStream(0, &header, sizeof header);
+	return header.DecompressedSize.Value();
+}
+
+// SHA-1 of the decoded content of an entry.
+static Sqex::Sqpack::Sha1Value HashDecodedEntry(const std::shared_ptr<Sqex::Sqpack::EntryProvider>& provider) {
+	thread_local std::vector<uint8_t> buf;
+
+	const auto decoded = Sqex::Sqpack::EntryRawStream(provider);
+	const auto size = decoded.StreamSize();
+
+	CryptoPP::SHA1 sha1;
+	if (size) {
+		buf.resize(static_cast<size_t>(std::min<uint64_t>(size, 1048576)));
+		Align<uint64_t>(size, buf.size()).IterateChunked([&](uint64_t, uint64_t offset, uint64_t length) {
+			const auto chunk = std::span(buf).subspan(0, static_cast<size_t>(length));
+			decoded.ReadStream(offset, chunk);
+			sha1.Update(chunk.data(), chunk.size());
+		});
+	}
+
+	Sqex::Sqpack::Sha1Value result;
+	sha1.Final(reinterpret_cast<byte*>(result.Value));
+	return result;
+}
+
+// Compares the decoded content of two entries byte by byte.
+static bool DecodedEntriesEqual(const std::shared_ptr<Sqex::Sqpack::EntryProvider>& provider1, const std::shared_ptr<Sqex::Sqpack::EntryProvider>& provider2) {
+	thread_local std::vector<uint8_t> buf1, buf2;
+
+	const auto decoded1 = Sqex::Sqpack::EntryRawStream(provider1);
+	const auto decoded2 = Sqex::Sqpack::EntryRawStream(provider2);
+	const auto size = decoded1.StreamSize();
+	if (size != decoded2.StreamSize())
+		return false;
+	if (!size)
+		return true;
+
+	buf1.resize(static_cast<size_t>(std::min<uint64_t>(size, 1048576)));
+	buf2.resize(buf1.size());
+	auto equal = true;
+	Align<uint64_t>(size, buf1.size()).IterateChunked([&](uint64_t, uint64_t offset, uint64_t length) {
+		if (!equal)
+			return;
+		const auto chunk1 = std::span(buf1).subspan(0, static_cast<size_t>(length));
+		const auto chunk2 = std::span(buf2).subspan(0, static_cast<size_t>(length));
+		decoded1.ReadStream(offset, chunk1);
+		decoded2.ReadStream(offset, chunk2);
+		equal = std::ranges::equal(chunk1, chunk2);
+	});
+	return equal;
+}
+
+// Maps entries that can be served from the data allocation of another entry to that entry.
+static std::map<Sqex::Sqpack::Creator::Entry*, Sqex::Sqpack::Creator::Entry*> FindDuplicateEntries(std::span<Sqex::Sqpack::Creator::Entry* const> entries, Sqex::Sqpack::Creator::Deduplication mode) {
+	using Sqex::Sqpack::Creator;
+
+	std::map<Creator::Entry*, Creator::Entry*> result;
+	if (mode == Creator::Deduplication::None)
+		return result;
+
+	std::map<std::tuple<const Sqex::RandomAccessStream*, uint64_t, uint64_t>, Creator::Entry*> bySource;
+	std::vector<Creator::Entry*> candidates;
+	for (const auto entry : entries) {
+		if (entry->Reserved)
+			continue;
+
+		const auto size = entry->Provider->StreamSize();
+		if (const auto backing = entry->Provider->BackingStream(); backing.Stream) {
+			if (const auto [it, inserted] = bySource.emplace(std::make_tuple(backing.Stream.get(), backing.Offset, size), entry); !inserted) {
+				result.emplace(entry, it->second);
+				continue;
+			}
+		}
+
+		if (mode == Creator::Deduplication::SameContent)
+			candidates.emplace_back(entry);
+	}
+
+	if (mode != Creator::Deduplication::SameContent)
+		return result;
+
+	// Only entries sharing both type and decoded size with another entry can possibly be identical.
+	std::vector<std::optional<uint64_t>> decodedSizes(candidates.size());
+	Utils::Win32::ParallelFor(candidates.size(), [&](size_t i) {
+		decodedSizes[i] = DecodedEntrySize(*candidates[i]->Provider);
+	});
+
+	std::map<std::pair<Sqex::Sqpack::SqData::FileEntryType, uint64_t>, std::vector<size_t>> bySize;
+	for (size_t i = 0; i < candidates.size(); ++i) {
+		if (decodedSizes[i])
+			bySize[std::make_pair(candidates[i]->Provider->EntryType(), *decodedSizes[i])].emplace_back(i);
+	}
+
+	std::vector<size_t> hashed;
+	for (const auto& group : bySize | std::views::values) {
+		if (group.size() > 1)
+			hashed.insert(hashed.end(), group.begin(), group.end());
+	}
+
+	std::vector<Sqex::Sqpack::Sha1Value> hashes(hashed.size());
+	Utils::Win32::ParallelFor(hashed.size(), [&](size_t i) {
+		hashes[i] = HashDecodedEntry(candidates[hashed[i]]->Provider);
+	});
+
+	// Matching hashes only nominate an entry; it gets merged after its decoded content compares equal to that of the primary.
+	std::map<std::tuple<Sqex::Sqpack::SqData::FileEntryType, uint64_t, std::string>, std::vector<Creator::Entry*>> byContent;
+	for (size_t i = 0; i < hashed.size(); ++i) {
+		const auto entry = candidates[hashed[i]];
+		const auto key = std::make_tuple(entry->Provider->EntryType(), *decodedSizes[hashed[i]], std::string(hashes[i].Value, sizeof hashes[i].Value));
+		auto& primaries = byContent[key];
+
+		const auto primary = std::ranges::find_if(primaries, [entry](Creator::Entry* p) {
+			return DecodedEntriesEqual(p->Provider, entry->Provider);
+		});
+		if (primary == primaries.end())
+			primaries.emplace_back(entry);
+		else
+			result.emplace(entry, *primary);
+	}
+	return result;
+}
+
+Sqex::Sqpack::Creator::SqpackViews Sqex::Sqpack::Creator::AsViews(bool strict, const std::shared_ptr<SqpackViewEntryCache>&dataBuffer, Deduplication deduplication) {
 	SqpackHeader dataHeader{};
 	std::vector<SqData::Header> dataSubheaders;
 	std::vector<std::pair<size_t, size_t>> dataEntryRanges;
@@ -493,7 +679,15 @@ Sqex::Sqpack::Creator::SqpackViews Sqex::Sqpack::Creator::AsViews(bool strict, c
 		fullHashes[pathSpec.FullPathHash].emplace_back(entry);
 	}
 
-	for (size_t i = 0; i < res.Entries.size(); ++i) {
+	// Duplicates go after every entry that gets its own allocation.
+	const auto duplicates = FindDuplicateEntries(res.Entries, deduplication);
+	for (const auto& [duplicate, primary] : duplicates)
+		duplicate->SharedAllocation = primary->SharedAllocation = true;
+	const auto allocatedCount = static_cast<size_t>(std::ranges::stable_partition(res.Entries, [&duplicates](Entry* entry) {
+		return !duplicates.contains(entry);
+	}).begin() - res.Entries.begin());
+
+	for (size_t i = 0; i < allocatedCount; ++i) {
 		auto& entry = res.Entries[i];
 		const auto& pathSpec = entry->Provider->PathSpec();
 		entry->EntrySize = Align(std::max(entry->EntrySize, static_cast<uint32_t>(entry->Provider->StreamSize()))).Alloc;
@@ -501,22 +695,6 @@ Sqex::Sqpack::Creator::SqpackViews Sqex::Sqpack::Creator::AsViews(bool strict, c
 
 		if (dataSubheaders.empty() ||
 			sizeof SqpackHeader + sizeof SqData::Header + dataSubheaders.back().DataSize + entry->EntrySize > dataSubheaders.back().MaxFileSize) {
-			if (strict && !dataSubheaders.empty()) {
-				CryptoPP::SHA1 sha1;
-				for (auto j = dataEntryRanges.back().first, j_ = j + dataEntryRanges.back().second; j < j_; ++j) {
-					const auto& entry = res.Entries[j];
-					const auto& provider = *entry->Provider;
-					const auto length = provider.StreamSize();
-					uint8_t buf[4096];
-					for (uint64_t j = 0; j < length; j += sizeof buf) {
-						const auto readlen = static_cast<size_t>(std::min<uint64_t>(sizeof buf, length - j));
-						provider.ReadStream(j, buf, readlen);
-						sha1.Update(buf, readlen);
-					}
-				}
-				sha1.Final(reinterpret_cast<byte*>(dataSubheaders.back().DataSha1.Value));
-				dataSubheaders.back().Sha1.SetFromSpan(reinterpret_cast<char*>(&dataSubheaders.back()), offsetof(Sqpack::SqData::Header, Sha1));
-			}
 			dataSubheaders.emplace_back(SqData::Header{
 				.HeaderSize = sizeof SqData::Header,
 				.Unknown1 = SqData::Header::Unknown1_Value,
@@ -533,21 +711,25 @@ Sqex::Sqpack::Creator::SqpackViews Sqex::Sqpack::Creator::AsViews(bool strict, c
 		dataEntryRanges.back().second++;
 	}
 
-	if (strict && !dataSubheaders.empty()) {
-		CryptoPP::SHA1 sha1;
-		for (auto j = dataEntryRanges.back().first, j_ = j + dataEntryRanges.back().second; j < j_; ++j) {
-			const auto& entry = res.Entries[j];
-			const auto& provider = *entry->Provider;
-			const auto length = provider.StreamSize();
-			uint8_t buf[4096];
-			for (uint64_t j = 0; j < length; j += sizeof buf) {
-				const auto readlen = static_cast<size_t>(std::min<uint64_t>(sizeof buf, length - j));
-				provider.ReadStream(j, buf, readlen);
-				sha1.Update(buf, readlen);
-			}
-		}
-		sha1.Final(reinterpret_cast<byte*>(dataSubheaders.back().DataSha1.Value));
-		dataSubheaders.back().Sha1.SetFromSpan(reinterpret_cast<char*>(&dataSubheaders.back()), offsetof(Sqpack::SqData::Header, Sha1));
+	// Duplicates read from the same provider instance as the entry they share the allocation with.
+	for (size_t i = allocatedCount; i < res.Entries.size(); ++i) {
+		auto& entry = res.Entries[i];
+		const auto primary = duplicates.at(entry);
+		const auto pathSpec = entry->Provider->PathSpec();
+		res.DeduplicatedBytes += Align(std::max(entry->EntrySize, static_cast<uint32_t>(entry->Provider->StreamSize()))).Alloc;
+		entry->EntrySize = primary->EntrySize;
+		entry->Locator = primary->Locator;
+		entry->Provider = std::make_shared<HotSwappableEntryProvider>(pathSpec, entry->EntrySize, static_cast<HotSwappableEntryProvider*>(primary->Provider.get())->GetBaseStream());
+	}
+	res.DeduplicatedEntryCount = res.Entries.size() - allocatedCount;
+
+	// Data files do not depend on each other, so hash them concurrently.
+	if (strict) {
+		Utils::Win32::ParallelFor(dataSubheaders.size(), [&](size_t i) {
+			auto& subheader = dataSubheaders[i];
+			HashEntries(subheader.DataSha1, std::span(res.Entries).subspan(dataEntryRanges[i].first, dataEntryRanges[i].second));
+			subheader.Sha1.SetFromSpan(reinterpret_cast<char*>(&subheader), offsetof(Sqpack::SqData::Header, Sha1));
+		});
 	}
 
 	std::vector<SqIndex::PairHashLocator> fileEntries1;
@@ -640,7 +822,7 @@ std::vector<Sqex::Sqpack::EntryPathSpec> Sqex::Sqpack::Creator::AllPathSpec() co
 	return res;
 }
 
-void Sqex::Sqpack::Creator::WriteToFiles(const std::filesystem::path & dir, bool strict) {
+void Sqex::Sqpack::Creator::WriteToFiles(const std::filesystem::path & dir, bool strict, Deduplication deduplication) {
 	SqpackHeader dataHeader{};
 	memcpy(dataHeader.Signature, SqpackHeader::Signature_Value, sizeof SqpackHeader::Signature_Value);
 	dataHeader.HeaderSize = sizeof SqpackHeader;
@@ -671,11 +853,20 @@ void Sqex::Sqpack::Creator::WriteToFiles(const std::filesystem::path & dir, bool
 		fullHashes[pathSpec.FullPathHash].emplace_back(entry.get());
 	}
 
+	std::vector<Entry*> entryPointers;
+	entryPointers.reserve(entries.size());
+	for (const auto& entry : entries)
+		entryPointers.emplace_back(entry.get());
+	const auto duplicates = FindDuplicateEntries(entryPointers, deduplication);
+	const auto allocatedCount = static_cast<size_t>(std::ranges::stable_partition(entries, [&duplicates](const std::unique_ptr<Entry>& entry) {
+		return !duplicates.contains(entry.get());
+	}).begin() - entries.begin());
+
 	std::vector<SqIndex::LEDataLocator> locators;
 
 	Utils::Win32::Handle dataFile;
 	std::vector<uint8_t> buf(1024 * 1024);
-	for (size_t i = 0; i < entries.size(); ++i) {
+	for (size_t i = 0; i < allocatedCount; ++i) {
 		auto& entry = *entries[i];
 		const auto provider{ std::move(entry.Provider) };
 		const auto entrySize = provider->StreamSize();
@@ -739,6 +930,17 @@ void Sqex::Sqpack::Creator::WriteToFiles(const std::filesystem::path & dir, bool
 		dataFile.Clear();
 	}
 
+	if (allocatedCount < entries.size()) {
+		uint64_t savedBytes = 0;
+		for (size_t i = allocatedCount; i < entries.size(); ++i) {
+			const auto primary = duplicates.at(entries[i].get());
+			entries[i]->Locator = primary->Locator;
+			savedBytes += entries[i]->Provider->StreamSize();
+		}
+		const auto duplicateCount = entries.size() - allocatedCount;
+		m_pImpl->Log("Deduplicated {} entries, saving {} bytes", duplicateCount, savedBytes);
+	}
+
 	std::vector<SqIndex::PairHashLocator> fileEntries1;
 	std::vector<SqIndex::PairHashWithTextLocator> conflictEntries1;
 	for (const auto& [pairHash, correspondingEntries] : pairHashes) {
@@ -801,17 +1003,169 @@ void Sqex::Sqpack::Creator::WriteToFiles(const std::filesystem::path & dir, bool
 			dataSubheaders.size(), std::move(fileEntries2), std::move(conflictEntries2), m_pImpl->m_sqpackIndex2Segment3, std::vector<SqIndex::PathHashLocator>(), strict)));
 }
 
-void Sqex::Sqpack::Creator::SqpackViewEntryCache::Flush() {
-	m_lastActiveEntry.ClearEntry();
+Sqex::Sqpack::Creator::SqpackViewEntryCache::BufferedEntry::BufferedEntry(const DataView* view, const Entry* entry)
+	: m_view(view)
+	, m_entry(entry)
+	, m_buffer(entry->EntrySize) {
+	entry->Provider->ReadStream(0, std::span(m_buffer));
+}
+
+void Sqex::Sqpack::Creator::SqpackViewEntryCache::FrequencySketch::Increment(size_t hash) {
+	for (size_t row = 0; row < Depth; ++row) {
+		auto& counter = m_counters[IndexOf(hash, row)];
+		if (counter < MaxCount)
+			++counter;
+	}
+
+	// Halve every counter once in a while, so that entries that were popular a long time ago can be evicted.
+	if (++m_additions >= Width * 10) {
+		for (auto& counter : m_counters)
+			counter >>= 1;
+		m_additions = 0;
+	}
+}
+
+uint8_t Sqex::Sqpack::Creator::SqpackViewEntryCache::FrequencySketch::Estimate(size_t hash) const {
+	auto result = MaxCount;
+	for (size_t row = 0; row < Depth; ++row)
+		result = std::min(result, m_counters[IndexOf(hash, row)]);
+	return result;
+}
+
+Sqex::Sqpack::Creator::SqpackViewEntryCache::SqpackViewEntryCache(uint64_t capacity, EvictionPolicy policy)
+	: m_capacity(capacity)
+	, m_policy(policy) {
 }
 
-Sqex::Sqpack::Creator::SqpackViewEntryCache::BufferedEntry* Sqex::Sqpack::Creator::SqpackViewEntryCache::GetBuffer(const DataView * view, const Entry * entry) {
-	if (m_lastActiveEntry.IsEntry(view, entry))
-		return &m_lastActiveEntry;
+std::shared_ptr<const Sqex::Sqpack::Creator::SqpackViewEntryCache::BufferedEntry> Sqex::Sqpack::Creator::SqpackViewEntryCache::Load(const DataView* view, const Entry* entry) {
+	auto result = std::make_shared<const BufferedEntry>(view, entry);
+	m_bytesRegenerated += entry->EntrySize;
+	return result;
+}
 
+void Sqex::Sqpack::Creator::SqpackViewEntryCache::Admit(Shard& shard, size_t hash, std::shared_ptr<const BufferedEntry> item) {
+	const auto size = item->Buffer().size_bytes();
+	const auto capacity = m_capacity / ShardCount;
+	while (!shard.Items.empty() && shard.ByteCount + size > capacity) {
+		const auto& victim = shard.Items.back();
+		if (m_policy == EvictionPolicy::TinyLfu && shard.Sketch.Estimate(KeyHash()(victim->GetEntry())) >= shard.Sketch.Estimate(hash)) {
+			++m_rejections;
+			return;
+		}
+
+		shard.ByteCount -= victim->Buffer().size_bytes();
+		shard.Index.erase(victim->GetEntry());
+		shard.Items.pop_back();
+		++m_evictions;
+	}
+
+	shard.ByteCount += size;
+	shard.Items.emplace_front(std::move(item));
+	shard.Index.emplace(shard.Items.front()->GetEntry(), shard.Items.begin());
+}
+
+std::shared_ptr<const Sqex::Sqpack::Creator::SqpackViewEntryCache::BufferedEntry> Sqex::Sqpack::Creator::SqpackViewEntryCache::GetBuffer(const DataView* view, const Entry* entry) {
 	if (entry->EntrySize > LargeEntryBufferSizeMax)
 		return nullptr;
 
-	m_lastActiveEntry.SetEntry(view, entry);
-	return &m_lastActiveEntry;
+	if (entry->EntrySize > m_capacity / ShardCount) {
+		const auto lock = std::lock_guard(m_largeEntryMtx);
+		if (m_largeEntry && m_largeEntry->IsEntry(view, entry)) {
+			++m_hits;
+			return m_largeEntry;
+		}
+
+		++m_misses;
+		m_largeEntry = nullptr;
+		m_largeEntry = Load(view, entry);
+		return m_largeEntry;
+	}
+
+	const auto key = Key(view, entry);
+	const auto hash = KeyHash()(key);
+	auto& shard = m_shards[hash % ShardCount];
+
+	uint64_t generation;
+	{
+		const auto lock = std::lock_guard(shard.Mtx);
+		generation = shard.Generation;
+		shard.Sketch.Increment(hash);
+		if (const auto it = shard.Index.find(key); it != shard.Index.end()) {
+			shard.Items.splice(shard.Items.begin(), shard.Items, it->second);
+			++m_hits;
+			return shard.Items.front();
+		}
+	}
+
+	// Generate the entry without holding the lock; other entries in the same shard remain accessible meanwhile.
+	++m_misses;
+	auto item = Load(view, entry);
+
+	const auto lock = std::lock_guard(shard.Mtx);
+	if (const auto it = shard.Index.find(key); it != shard.Index.end())
+		return *it->second;
+
+	// The entry may have been generated from a stream that got swapped out while we were loading it.
+	if (generation != shard.Generation)
+		return item;
+
+	Admit(shard, hash, item);
+	return item;
+}
+
+void Sqex::Sqpack::Creator::SqpackViewEntryCache::Forget(const DataView* view) {
+	for (auto& shard : m_shards) {
+		const auto lock = std::lock_guard(shard.Mtx);
+		for (auto it = shard.Items.begin(); it != shard.Items.end();) {
+			if ((*it)->GetEntry().first == view) {
+				shard.ByteCount -= (*it)->Buffer().size_bytes();
+				shard.Index.erase((*it)->GetEntry());
+				it = shard.Items.erase(it);
+			} else
+				++it;
+		}
+		++shard.Generation;
+	}
+
+	const auto lock = std::lock_guard(m_largeEntryMtx);
+	if (m_largeEntry && m_largeEntry->GetEntry().first == view)
+		m_largeEntry = nullptr;
+}
+
+void Sqex::Sqpack::Creator::SqpackViewEntryCache::Flush() {
+	for (auto& shard : m_shards) {
+		const auto lock = std::lock_guard(shard.Mtx);
+		shard.Index.clear();
+		shard.Items.clear();
+		shard.ByteCount = 0;
+		++shard.Generation;
+	}
+
+	const auto lock = std::lock_guard(m_largeEntryMtx);
+	m_largeEntry = nullptr;
+}
+
+Sqex::Sqpack::Creator::SqpackViewEntryCache::Statistics Sqex::Sqpack::Creator::SqpackViewEntryCache::GetStatistics() {
+	auto result = Statistics{
+		.Hits = m_hits,
+		.Misses = m_misses,
+		.Evictions = m_evictions,
+		.Rejections = m_rejections,
+		.BytesRegenerated = m_bytesRegenerated,
+		.EntryCount = 0,
+		.ByteCount = 0,
+		.Capacity = m_capacity,
+	};
+	for (auto& shard : m_shards) {
+		const auto lock = std::lock_guard(shard.Mtx);
+		result.EntryCount += shard.Items.size();
+		result.ByteCount += shard.ByteCount;
+	}
+
+	const auto lock = std::lock_guard(m_largeEntryMtx);
+	if (m_largeEntry) {
+		result.EntryCount += 1;
+		result.ByteCount += m_largeEntry->Buffer().size_bytes();
+	}
+	return result;
 }
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 #include "XivAlexanderCommon/Sqex/Sqpack.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/EntryProvider.h"
 #include "XivAlexanderCommon/Utils/ListenerManager.h"
@@ -10,6 +16,8 @@ namespace Sqex::ThirdParty::TexTools {
 }
 
 namespace Sqex::Sqpack {
+	class BuildCache;
+
 	class Creator {
 		const uint64_t m_maxFileSize;
 
@@ -42,6 +50,8 @@ namespace Sqex::Sqpack {
 		AddEntryResult AddEntryFromFile(EntryPathSpec pathSpec, const std::filesystem::path& path, bool overwriteExisting = true);
 		AddEntryResult AddAllEntriesFromSimpleTTMP(const std::filesystem::path& extractedDir, bool overwriteExisting = true);
 		void ReserveSpacesFromTTMP(const ThirdParty::TexTools::TTMPL& ttmpl, const std::shared_ptr<Sqex::RandomAccessStream>& ttmpd);
+		// Reuses reservations recorded in cache while neither the TTMPL nor the TTMPD file has changed.
+		void ReserveSpacesFromTTMP(const ThirdParty::TexTools::TTMPL& ttmpl, const std::shared_ptr<Sqex::RandomAccessStream>& ttmpd, BuildCache& cache, const std::filesystem::path& ttmplPath, const std::filesystem::path& ttmpdPath);
 		AddEntryResult AddEntry(std::shared_ptr<EntryProvider> provider, bool overwriteExisting = true);
 		void ReserveSwappableSpace(EntryPathSpec pathSpec, uint32_t size);
 
@@ -54,6 +64,25 @@ namespace Sqex::Sqpack {
 			SqIndex::LEDataLocator Locator{};
 
 			std::shared_ptr<EntryProvider> Provider;
+
+			// Space was reserved using ReserveSwappableSpace, so the data is expected to be swapped later; never shares its allocation.
+			bool Reserved{};
+
+			// Data allocation is shared with other entries of identical data, so the data must not be swapped.
+			bool SharedAllocation{};
+		};
+
+		// How AsViews and WriteToFiles find entries that can be served from a single data allocation.
+		// Use None for views whose entries may be swapped at runtime, as shared entries cannot be swapped.
+		enum class Deduplication {
+			None,
+
+			// Entries stored at the same place of the same source stream, such as paths that the source index already points to the same data.
+			SameSource,
+
+			// SameSource, and then entries that decode to identical data, found by hashing the decoded data of entries of the same type and decoded size
+			// and confirmed by comparing it byte by byte. Duplicates are served the encoded data of the first such entry.
+			SameContent,
 		};
 
 		struct SqpackViews {
@@ -63,72 +92,137 @@ namespace Sqex::Sqpack {
 			std::vector<Entry*> Entries;
 			std::map<EntryPathSpec, std::unique_ptr<Entry>, EntryPathSpec::AllHashComparator> HashOnlyEntries;
 			std::map<EntryPathSpec, std::unique_ptr<Entry>, EntryPathSpec::FullPathComparator> FullPathEntries;
+
+			// Number of entries served from the allocation of another entry, and the bytes they would have taken otherwise.
+			size_t DeduplicatedEntryCount{};
+			uint64_t DeduplicatedBytes{};
 		};
 
+		/*
+		 * Keeps whole entries of data views in memory, so that reads from entries that have to be generated on the fly
+		 * do not regenerate the entry every time the game asks for a piece of it.
+		 * Entries are spread over independently locked shards, each holding up to its share of the byte budget.
+		 * An entry too big for a shard but no bigger than LargeEntryBufferSizeMax occupies a single dedicated slot instead.
+		 */
 		class SqpackViewEntryCache {
 			static constexpr auto SmallEntryBufferSize = (INTPTR_MAX == INT64_MAX ? 256 : 8) * 1048576;
 			static constexpr auto LargeEntryBufferSizeMax = (INTPTR_MAX == INT64_MAX ? 1024 : 64) * 1048576;
 
 		public:
+			enum class EvictionPolicy {
+				// Least recently used entry makes room for any new entry.
+				Lru,
+
+				// Least recently used entry makes room only for an entry that has been requested more often,
+				// as estimated from a count-min sketch of recent requests. Keeps scans from flushing hot entries.
+				TinyLfu,
+			};
+
+			static constexpr size_t ShardCount = 8;
+			static constexpr uint64_t DefaultCapacity = SmallEntryBufferSize;
+
 			class BufferedEntry {
-				const DataView* m_view = nullptr;
-				const Entry* m_entry = nullptr;
-				std::vector<uint8_t> m_bufferPreallocated;
-				std::vector<uint8_t> m_bufferTemporary;
-				std::span<uint8_t> m_bufferActive;
+				const DataView* const m_view;
+				const Entry* const m_entry;
+				std::vector<uint8_t> m_buffer;
 
 			public:
-				bool Empty() const {
-					return m_view == nullptr || m_entry == nullptr;
-				}
+				BufferedEntry(const DataView* view, const Entry* entry);
 
 				bool IsEntry(const DataView* view, const Entry* entry) const {
 					return m_view == view && m_entry == entry;
 				}
 
-				void ClearEntry() {
-					m_view = nullptr;
-					m_entry = nullptr;
-					if (!m_bufferTemporary.empty())
-						std::vector<uint8_t>().swap(m_bufferTemporary);
-				}
-
 				auto GetEntry() const {
 					return std::make_pair(m_view, m_entry);
 				}
 
-				void SetEntry(const DataView* view, const Entry* entry) {
-					m_view = view;
-					m_entry = entry;
-
-					if (entry->EntrySize <= SmallEntryBufferSize) {
-						if (!m_bufferTemporary.empty())
-							std::vector<uint8_t>().swap(m_bufferTemporary);
-						if (m_bufferPreallocated.size() != SmallEntryBufferSize)
-							m_bufferPreallocated.resize(SmallEntryBufferSize);
-						m_bufferActive = std::span(m_bufferPreallocated.begin(), entry->EntrySize);
-					} else {
-						m_bufferTemporary.resize(entry->EntrySize);
-						m_bufferActive = std::span(m_bufferTemporary);
-					}
-					entry->Provider->ReadStream(0, m_bufferActive);
+				std::span<const uint8_t> Buffer() const {
+					return m_buffer;
 				}
+			};
 
-				const auto& Buffer() const {
-					return m_bufferActive;
-				}
+			struct Statistics {
+				uint64_t Hits;
+				uint64_t Misses;
+				uint64_t Evictions;
+				uint64_t Rejections;
+				uint64_t BytesRegenerated;
+				uint64_t EntryCount;
+				uint64_t ByteCount;
+				uint64_t Capacity;
 			};
 
 		private:
-			BufferedEntry m_lastActiveEntry;
+			using Key = std::pair<const DataView*, const Entry*>;
+
+			struct KeyHash {
+				size_t operator()(const Key& key) const {
+					return std::hash<const void*>()(key.first) * 31 + std::hash<const void*>()(key.second);
+				}
+			};
+
+			class FrequencySketch {
+				static constexpr size_t Width = 4096;
+				static constexpr size_t Depth = 4;
+				static constexpr uint8_t MaxCount = 15;
+
+				std::vector<uint8_t> m_counters;
+				size_t m_additions = 0;
+
+				static size_t IndexOf(size_t hash, size_t row) {
+					hash ^= hash >> 17;
+					hash *= 0x9E3779B97F4A7C15ULL + 2 * row;
+					return row * Width + (hash >> 7) % Width;
+				}
+
+			public:
+				FrequencySketch() : m_counters(Width * Depth) {}
+
+				void Increment(size_t hash);
+				[[nodiscard]] uint8_t Estimate(size_t hash) const;
+			};
+
+			struct Shard {
+				std::mutex Mtx;
+				std::list<std::shared_ptr<const BufferedEntry>> Items;  // most recently used first
+				std::unordered_map<Key, std::list<std::shared_ptr<const BufferedEntry>>::iterator, KeyHash> Index;
+				FrequencySketch Sketch;
+				uint64_t ByteCount = 0;
+				uint64_t Generation = 0;  // incremented whenever entries are dropped by Forget or Flush
+			};
+
+			const uint64_t m_capacity;
+			const EvictionPolicy m_policy;
+			std::array<Shard, ShardCount> m_shards;
+
+			std::mutex m_largeEntryMtx;
+			std::shared_ptr<const BufferedEntry> m_largeEntry;
+
+			std::atomic<uint64_t> m_hits = 0;
+			std::atomic<uint64_t> m_misses = 0;
+			std::atomic<uint64_t> m_evictions = 0;
+			std::atomic<uint64_t> m_rejections = 0;
+			std::atomic<uint64_t> m_bytesRegenerated = 0;
+
+			std::shared_ptr<const BufferedEntry> Load(const DataView* view, const Entry* entry);
+			void Admit(Shard& shard, size_t hash, std::shared_ptr<const BufferedEntry> item);
 
 		public:
-			BufferedEntry* GetBuffer(const DataView* view, const Entry* entry);
+			SqpackViewEntryCache(uint64_t capacity = DefaultCapacity, EvictionPolicy policy = EvictionPolicy::Lru);
+
+			// Returns nullptr if the entry is too big to be buffered as a whole; read from the provider directly in that case.
+			std::shared_ptr<const BufferedEntry> GetBuffer(const DataView* view, const Entry* entry);
+
+			// Drops every entry of the view, so that a view or entry allocated at the same address later will not see stale data.
+			void Forget(const DataView* view);
 			void Flush();
+
+			[[nodiscard]] Statistics GetStatistics();
 		};
 
-		SqpackViews AsViews(bool strict, const std::shared_ptr<SqpackViewEntryCache>& buffer = nullptr);
-		void WriteToFiles(const std::filesystem::path& dir, bool strict = false);
+		SqpackViews AsViews(bool strict, const std::shared_ptr<SqpackViewEntryCache>& buffer = nullptr, Deduplication deduplication = Deduplication::None);
+		void WriteToFiles(const std::filesystem::path& dir, bool strict = false, Deduplication deduplication = Deduplication::None);
 
 		std::shared_ptr<RandomAccessStream> operator[](const EntryPathSpec& pathSpec) const;
 		std::vector<EntryPathSpec> AllPathSpec() const;
@@ -7,12 +7,20 @@ namespace Sqex::Sqpack {
 		EntryPathSpec m_pathSpec;
 
 	public:
+		struct BackingStreamView {
+			std::shared_ptr<const RandomAccessStream> Stream;
+			uint64_t Offset{};
+		};
+
 		EntryProvider(EntryPathSpec pathSpec);
 
 		bool UpdatePathSpec(const EntryPathSpec& r);
 
 		[[nodiscard]] const EntryPathSpec& PathSpec() const;
 		[[nodiscard]] virtual SqData::FileEntryType EntryType() const = 0;
+
+		// Immutable stream this entry is stored in as-is, and where; used to share decoded blocks between readers of the same data.
+		[[nodiscard]] virtual BackingStreamView BackingStream() const { return {}; }
 		[[nodiscard]] std::string DescribeState() const override { return std::format("EntryProvider({})", m_pathSpec); }
 	};
 }
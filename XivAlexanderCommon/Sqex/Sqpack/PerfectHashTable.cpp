@@ -0,0 +1,63 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/PerfectHashTable.h"
+
+Sqex::Sqpack::PerfectHashTable::PerfectHashTable(std::span<const uint64_t> keys) {
+	if (keys.empty())
+		return;
+	if (keys.size() >= NotFound)
+		throw std::invalid_argument("Too many keys");
+
+	{
+		std::vector<uint64_t> sorted(keys.begin(), keys.end());
+		std::ranges::sort(sorted);
+		if (std::ranges::adjacent_find(sorted) != sorted.end())
+			throw std::invalid_argument("Duplicate key");
+	}
+
+	// Around 4 keys per bucket and 1% spare slots keeps construction fast while lookup stays at one probe.
+	const auto bucketCount = (keys.size() + 3) / 4;
+	const auto slotCount = keys.size() + keys.size() / 100 + 1;
+
+	std::vector<std::vector<uint32_t>> buckets(bucketCount);
+	for (uint32_t i = 0; i < keys.size(); ++i)
+		buckets[static_cast<size_t>(Mix(keys[i], 0) % bucketCount)].emplace_back(i);
+
+	std::vector<uint32_t> order(bucketCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::ranges::stable_sort(order, [&buckets](uint32_t l, uint32_t r) {
+		return buckets[l].size() > buckets[r].size();
+	});
+
+	m_seeds.resize(bucketCount, 0);
+	m_keys.resize(slotCount, 0);
+	m_values.resize(slotCount, NotFound);
+
+	std::vector<size_t> slots;
+	for (const auto bucketIndex : order) {
+		const auto& bucket = buckets[bucketIndex];
+		if (bucket.empty())
+			break;
+
+		for (uint32_t seed = 1; ; ++seed) {
+			if (seed == NotFound)
+				throw std::runtime_error("Failed to find a seed for perfect hash bucket");
+
+			slots.clear();
+			for (const auto keyIndex : bucket) {
+				const auto slot = static_cast<size_t>(Mix(keys[keyIndex], seed) % slotCount);
+				if (m_values[slot] != NotFound || std::ranges::find(slots, slot) != slots.end())
+					break;
+				slots.emplace_back(slot);
+			}
+			if (slots.size() != bucket.size())
+				continue;
+
+			for (size_t i = 0; i < slots.size(); ++i) {
+				m_keys[slots[i]] = keys[bucket[i]];
+				m_values[slots[i]] = bucket[i];
+			}
+			m_seeds[bucketIndex] = seed;
+			break;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+namespace Sqex::Sqpack {
+	/*
+	 * Perfect hash table over a fixed set of unique 64-bit keys, built with hash-and-displace (CHD).
+	 * Keys are grouped into buckets; each bucket gets a seed that sends all of its keys to distinct free slots.
+	 * Lookup computes the bucket, reads its seed, and probes exactly one slot, followed by a key comparison.
+	 */
+	class PerfectHashTable {
+		std::vector<uint32_t> m_seeds;
+		std::vector<uint64_t> m_keys;
+		std::vector<uint32_t> m_values;
+
+		static uint64_t Mix(uint64_t key, uint64_t seed) {
+			key += 0x9E3779B97F4A7C15ULL * (seed + 1);
+			key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+			return key ^ (key >> 31);
+		}
+
+	public:
+		static constexpr uint32_t NotFound = UINT32_MAX;
+
+		PerfectHashTable() = default;
+
+		// Value for each key is its index in keys. Throws std::invalid_argument on duplicate keys.
+		PerfectHashTable(std::span<const uint64_t> keys);
+
+		[[nodiscard]] bool Empty() const {
+			return m_keys.empty();
+		}
+
+		[[nodiscard]] uint32_t Find(uint64_t key) const {
+			if (m_keys.empty())
+				return NotFound;
+			const auto seed = m_seeds[static_cast<size_t>(Mix(key, 0) % m_seeds.size())];
+			const auto slot = static_cast<size_t>(Mix(key, seed) % m_keys.size());
+			return m_keys[slot] == key ? m_values[slot] : NotFound;
+		}
+	};
+}
@@ -21,6 +21,17 @@ uint64_t Sqex::Sqpack::RandomAccessStreamAsEntryProviderView::ReadStreamPartial(
 	return m_stream->ReadStreamPartial(m_offset + offset, buf, static_cast<size_t>(std::min(length, m_size - offset)));
 }
 
+void Sqex::Sqpack::RandomAccessStreamAsEntryProviderView::ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const {
+	auto translated = std::vector(requests.begin(), requests.end());
+	for (auto& request : translated) {
+		request.Length = request.Offset >= m_size ? 0 : std::min(request.Length, m_size - request.Offset);
+		request.Offset += m_offset;
+	}
+	m_stream->ReadStreamPartialBatch(translated);
+	for (size_t i = 0; i < requests.size(); ++i)
+		requests[i].Read = translated[i].Read;
+}
+
 Sqex::Sqpack::SqData::FileEntryType Sqex::Sqpack::RandomAccessStreamAsEntryProviderView::EntryType() const {
 	if (!m_entryType) {
 		// operation that should be lightweight enough that lock should not be needed
@@ -29,6 +40,10 @@ Sqex::Sqpack::SqData::FileEntryType Sqex::Sqpack::RandomAccessStreamAsEntryProvi
 	return *m_entryType;
 }
 
+Sqex::Sqpack::EntryProvider::BackingStreamView Sqex::Sqpack::RandomAccessStreamAsEntryProviderView::BackingStream() const {
+	return { m_stream, m_offset };
+}
+
 std::string Sqex::Sqpack::RandomAccessStreamAsEntryProviderView::DescribeState() const {
 	return std::format("RandomAccessStreamAsEntryProviderView({}, {}, {})", m_stream->DescribeState(), m_offset, m_size);
 }
@@ -15,7 +15,9 @@ namespace Sqex::Sqpack {
 
 		[[nodiscard]] uint64_t StreamSize() const override;
 		uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const override;
+		void ReadStreamPartialBatch(std::span<BatchReadRequest> requests) const override;
 		[[nodiscard]] SqData::FileEntryType EntryType() const override;
+		[[nodiscard]] BackingStreamView BackingStream() const override;
 		[[nodiscard]] std::string DescribeState() const override;
 	};
 }
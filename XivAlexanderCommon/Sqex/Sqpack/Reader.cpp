@@ -6,7 +6,13 @@
 
 template<typename HashLocatorT, typename TextLocatorT>
 Sqex::Sqpack::Reader::SqIndexType<HashLocatorT, TextLocatorT>::SqIndexType(const RandomAccessStream& stream, bool strictVerify)
-	: Data(stream.ReadStreamIntoVector<uint8_t>(0))
+	: m_mapped([&stream]() -> std::shared_ptr<const MemoryMappedFileRandomAccessStream> {
+		if (!dynamic_cast<const MemoryMappedFileRandomAccessStream*>(&stream))
+			return nullptr;
+		return std::static_pointer_cast<const MemoryMappedFileRandomAccessStream>(stream.shared_from_this());
+	}())
+	, m_buffer(m_mapped ? std::vector<uint8_t>() : stream.ReadStreamIntoVector<uint8_t>(0))
+	, Data(m_mapped ? m_mapped->AsSpan() : std::span<const uint8_t>(m_buffer))
 	, Header(*reinterpret_cast<const SqpackHeader*>(&Data[0]))
 	, IndexHeader(*reinterpret_cast<const SqIndex::Header*>(&Data[Header.HeaderSize]))
 	, HashLocators(span_cast<HashLocatorT>(Data, IndexHeader.HashLocatorSegment.Offset, IndexHeader.HashLocatorSegment.Size, 1))
@@ -28,9 +34,25 @@ Sqex::Sqpack::Reader::SqIndexType<HashLocatorT, TextLocatorT>::SqIndexType(const
 	}
 }
 
-Sqex::Sqpack::Reader::SqIndex1Type::SqIndex1Type(const RandomAccessStream& stream, bool strictVerify)
+template<typename HashLocatorT, typename KeyFn>
+static Sqex::Sqpack::PerfectHashTable BuildPerfectHashTable(std::span<const HashLocatorT> locators, const KeyFn& keyFn) {
+	std::vector<uint64_t> keys;
+	keys.reserve(locators.size());
+	for (const auto& locator : locators)
+		keys.emplace_back(keyFn(locator));
+
+	try {
+		return Sqex::Sqpack::PerfectHashTable(keys);
+	} catch (const std::exception&) {
+		// Leave it empty; lookups fall back to binary search.
+		return {};
+	}
+}
+
+Sqex::Sqpack::Reader::SqIndex1Type::SqIndex1Type(const RandomAccessStream& stream, bool strictVerify, bool buildPerfectHashTable)
 	: SqIndexType<SqIndex::PairHashLocator, SqIndex::PairHashWithTextLocator>(stream, strictVerify)
-	, PathHashLocators(span_cast<SqIndex::PathHashLocator>(Data, IndexHeader.PathHashLocatorSegment.Offset, IndexHeader.PathHashLocatorSegment.Size, 1)) {
+	, PathHashLocators(span_cast<SqIndex::PathHashLocator>(Data, IndexHeader.PathHashLocatorSegment.Offset, IndexHeader.PathHashLocatorSegment.Size, 1))
+	, m_pairHashTable(buildPerfectHashTable ? BuildPerfectHashTable(HashLocators, [](const SqIndex::PairHashLocator& l) { return (1ULL * l.PathHash << 32) | l.NameHash; }) : PerfectHashTable()) {
 	if (strictVerify) {
 		if (IndexHeader.PathHashLocatorSegment.Size % sizeof SqIndex::PathHashLocator)
 			throw CorruptDataException("PathHashLocators has an invalid size alignment");
@@ -47,6 +69,13 @@ std::span<const Sqex::Sqpack::SqIndex::PairHashLocator> Sqex::Sqpack::Reader::Sq
 }
 
 const Sqex::Sqpack::SqIndex::LEDataLocator& Sqex::Sqpack::Reader::SqIndex1Type::GetLocator(uint32_t pathHash, uint32_t nameHash) const {
+	if (!m_pairHashTable.Empty()) {
+		const auto index = m_pairHashTable.Find((1ULL * pathHash << 32) | nameHash);
+		if (index == PerfectHashTable::NotFound)
+			throw std::out_of_range(std::format("NameHash {:08x} in PathHash {:08x} not found", nameHash, pathHash));
+		return HashLocators[index].Locator;
+	}
+
 	const auto locators = GetPairHashLocators(pathHash);
 	const auto it = std::lower_bound(locators.begin(), locators.end(), nameHash, PathSpecComparator());
 	if (it == locators.end() || it->NameHash != nameHash)
@@ -54,11 +83,19 @@ const Sqex::Sqpack::SqIndex::LEDataLocator& Sqex::Sqpack::Reader::SqIndex1Type::
 	return it->Locator;
 }
 
-Sqex::Sqpack::Reader::SqIndex2Type::SqIndex2Type(const RandomAccessStream& stream, bool strictVerify)
-	: SqIndexType<SqIndex::FullHashLocator, SqIndex::FullHashWithTextLocator>(stream, strictVerify) {
+Sqex::Sqpack::Reader::SqIndex2Type::SqIndex2Type(const RandomAccessStream& stream, bool strictVerify, bool buildPerfectHashTable)
+	: SqIndexType<SqIndex::FullHashLocator, SqIndex::FullHashWithTextLocator>(stream, strictVerify)
+	, m_fullHashTable(buildPerfectHashTable ? BuildPerfectHashTable(HashLocators, [](const SqIndex::FullHashLocator& l) { return static_cast<uint64_t>(l.FullPathHash); }) : PerfectHashTable()) {
 }
 
 const Sqex::Sqpack::SqIndex::LEDataLocator& Sqex::Sqpack::Reader::SqIndex2Type::GetLocator(uint32_t fullPathHash) const {
+	if (!m_fullHashTable.Empty()) {
+		const auto index = m_fullHashTable.Find(fullPathHash);
+		if (index == PerfectHashTable::NotFound)
+			throw std::out_of_range(std::format("FullPathHash {:08x} not found", fullPathHash));
+		return HashLocators[index].Locator;
+	}
+
 	const auto it = std::lower_bound(HashLocators.begin(), HashLocators.end(), fullPathHash, PathSpecComparator());
 	if (it == HashLocators.end() || it->FullPathHash != fullPathHash)
 		throw std::out_of_range(std::format("FullPathHash {:08x} not found", fullPathHash));
@@ -86,10 +123,10 @@ Sqex::Sqpack::Reader::SqDataType::SqDataType(std::shared_ptr<RandomAccessStream>
 	}
 }
 
-Sqex::Sqpack::Reader::Reader(const std::filesystem::path& indexFile, bool strictVerify)
+Sqex::Sqpack::Reader::Reader(const std::filesystem::path& indexFile, bool strictVerify, bool buildPerfectHashTables)
 	: Reader(
-		std::make_shared<FileRandomAccessStream>(std::filesystem::path(indexFile).replace_extension(".index")),
-		std::make_shared<FileRandomAccessStream>(std::filesystem::path(indexFile).replace_extension(".index2")),
+		std::make_shared<MemoryMappedFileRandomAccessStream>(std::filesystem::path(indexFile).replace_extension(".index")),
+		std::make_shared<MemoryMappedFileRandomAccessStream>(std::filesystem::path(indexFile).replace_extension(".index2")),
 		[&]() {
 			std::vector<std::shared_ptr<RandomAccessStream>> streams;
 			for (int i = 0; i < 8; ++i) {
@@ -100,12 +137,13 @@ Sqex::Sqpack::Reader::Reader(const std::filesystem::path& indexFile, bool strict
 			}
 			return streams;
 		}(),
-		strictVerify) {
+		strictVerify,
+		buildPerfectHashTables) {
 }
 
-Sqex::Sqpack::Reader::Reader(std::shared_ptr<RandomAccessStream> indexStream1, std::shared_ptr<RandomAccessStream> indexStream2, std::vector<std::shared_ptr<RandomAccessStream>> dataStreams, bool strictVerify)
-	: Index1(*indexStream1, strictVerify)
-	, Index2(*indexStream2, strictVerify) {
+Sqex::Sqpack::Reader::Reader(std::shared_ptr<RandomAccessStream> indexStream1, std::shared_ptr<RandomAccessStream> indexStream2, std::vector<std::shared_ptr<RandomAccessStream>> dataStreams, bool strictVerify, bool buildPerfectHashTables)
+	: Index1(*indexStream1, strictVerify, buildPerfectHashTables)
+	, Index2(*indexStream2, strictVerify, buildPerfectHashTables) {
 
 	std::vector<std::pair<SqIndex::LEDataLocator, std::tuple<uint32_t, uint32_t, const char*>>> offsets1;
 	offsets1.reserve(
@@ -218,6 +256,10 @@ std::shared_ptr<Sqex::Sqpack::EntryProvider> Sqex::Sqpack::Reader::GetEntryProvi
 }
 
 std::shared_ptr<Sqex::Sqpack::EntryProvider> Sqex::Sqpack::Reader::GetEntryProvider(const EntryPathSpec& pathSpec) const {
+	return GetEntryProvider(pathSpec, GetLocator(pathSpec));
+}
+
+std::shared_ptr<Sqex::Sqpack::EntryProvider> Sqex::Sqpack::Reader::GetEntryProvider(const EntryPathSpec& pathSpec, SqIndex::LEDataLocator locator) const {
 	struct Comparator {
 		bool operator()(const std::pair<SqIndex::LEDataLocator, EntryInfoType>& l, const SqIndex::LEDataLocator& r) const {
 			return l.first < r;
@@ -228,7 +270,8 @@ std::shared_ptr<Sqex::Sqpack::EntryProvider> Sqex::Sqpack::Reader::GetEntryProvi
 		}
 	};
 
-	const auto& locator = GetLocator(pathSpec);
+	if (locator.IsSynonym)
+		locator = GetLocator(pathSpec);
 	const auto entryInfo = std::lower_bound(EntryInfo.begin(), EntryInfo.end(), locator, Comparator());
 	return GetEntryProvider(pathSpec, locator, entryInfo->second.Allocation);
 }
@@ -250,11 +293,28 @@ std::shared_ptr<Sqex::Sqpack::EntryProvider> Sqex::Sqpack::GameReader::GetEntryP
 		return GetReaderForPath(pathSpec).GetEntryProvider(pathSpec);
 
 	PreloadAllSqpackFiles();
-	for (const auto& reader : m_readers | std::views::values) {
+	const Route* route = nullptr;
+	if (pathSpec.HasFullPathHash()) {
+		if (const auto index = m_fullHashRouteTable.Find(pathSpec.FullPathHash); index != PerfectHashTable::NotFound)
+			route = &m_fullHashRoutes[index];
+	} else if (pathSpec.HasComponentHash()) {
+		if (const auto index = m_pairHashRouteTable.Find((1ULL * pathSpec.PathHash << 32) | pathSpec.NameHash); index != PerfectHashTable::NotFound)
+			route = &m_pairHashRoutes[index];
+	}
+
+	if (route) {
 		try {
-			return reader->GetEntryProvider(pathSpec);
+			return m_routeReaders[route->ReaderIndex]->GetEntryProvider(pathSpec, route->Locator);
 		} catch (const std::out_of_range&) {
-			// pass
+			// pass; a synonym may fail to resolve in the first reader having the hash, so try the rest as well
+		}
+
+		for (auto i = static_cast<size_t>(route->ReaderIndex) + 1; i < m_routeReaders.size(); ++i) {
+			try {
+				return m_routeReaders[i]->GetEntryProvider(pathSpec);
+			} catch (const std::out_of_range&) {
+				// pass
+			}
 		}
 	}
 	throw std::out_of_range("File not found in any sqpack file");
@@ -273,12 +333,18 @@ Sqex::Sqpack::Reader& Sqex::Sqpack::GameReader::GetReaderForPath(const EntryPath
 	const auto datFileName = rawPathSpec.DatFile();
 	auto& item = m_readers[datFileName];
 	if (!item)
-		item.emplace(m_gamePath / "sqpack" / rawPathSpec.DatExpac() / (datFileName + ".win32.index"));
+		item.emplace(m_gamePath / "sqpack" / rawPathSpec.DatExpac() / (datFileName + ".win32.index"), false, true);
 	return *item;
 }
 
 void Sqex::Sqpack::GameReader::PreloadAllSqpackFiles() const {
+	// Routes are built only after every sqpack file has been loaded, so there is nothing left to do once they exist.
+	if (m_routesBuilt)
+		return;
+
 	const auto lock = std::lock_guard(m_readersMtx);
+	if (m_routesBuilt)
+		return;
 
 	for (const auto& iter : std::filesystem::recursive_directory_iterator(m_gamePath / "sqpack")) {
 		if (iter.is_directory() || !iter.path().wstring().ends_with(L".win32.index"))
@@ -286,6 +352,43 @@ void Sqex::Sqpack::GameReader::PreloadAllSqpackFiles() const {
 		const auto datFileName = std::filesystem::path{ iter.path() }.replace_extension("").replace_extension("").string();
 		auto& item = m_readers[datFileName];
 		if (!item)
-			item.emplace(iter.path());
+			item.emplace(iter.path(), false, true);
+	}
+
+	BuildRoutes();
+}
+
+void Sqex::Sqpack::GameReader::BuildRoutes() const {
+	// If a hash exists in multiple readers, the first one in m_readers order wins.
+	std::vector<std::pair<uint64_t, Route>> pairHashRoutes, fullHashRoutes;
+	m_routeReaders.clear();
+	for (const auto& reader : m_readers | std::views::values) {
+		if (!reader)
+			continue;
+
+		const auto readerIndex = static_cast<uint32_t>(m_routeReaders.size());
+		m_routeReaders.emplace_back(&*reader);
+		for (const auto& locator : reader->Index1.HashLocators)
+			pairHashRoutes.emplace_back((1ULL * locator.PathHash << 32) | locator.NameHash, Route{ readerIndex, locator.Locator });
+		for (const auto& locator : reader->Index2.HashLocators)
+			fullHashRoutes.emplace_back(locator.FullPathHash, Route{ readerIndex, locator.Locator });
 	}
+
+	const auto finalize = [](std::vector<std::pair<uint64_t, Route>>& source, std::vector<Route>& routes, PerfectHashTable& table) {
+		std::ranges::stable_sort(source, {}, &std::pair<uint64_t, Route>::first);
+		const auto [eraseFrom, eraseTo] = std::ranges::unique(source, {}, &std::pair<uint64_t, Route>::first);
+		source.erase(eraseFrom, eraseTo);
+
+		std::vector<uint64_t> keys;
+		keys.reserve(source.size());
+		routes.reserve(source.size());
+		for (const auto& [key, route] : source) {
+			keys.emplace_back(key);
+			routes.emplace_back(route);
+		}
+		table = PerfectHashTable(keys);
+	};
+	finalize(pairHashRoutes, m_pairHashRoutes, m_pairHashRouteTable);
+	finalize(fullHashRoutes, m_fullHashRoutes, m_fullHashRouteTable);
+	m_routesBuilt = true;
 }
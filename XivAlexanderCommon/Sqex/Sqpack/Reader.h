@@ -1,14 +1,23 @@
 #pragma once
 
+#include <atomic>
+
 #include "XivAlexanderCommon/Sqex/Sqpack.h"
 #include "XivAlexanderCommon/Utils/Win32/Handle.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/EntryProvider.h"
+#include "XivAlexanderCommon/Sqex/Sqpack/PerfectHashTable.h"
 
 namespace Sqex::Sqpack {
 	struct Reader {
 		template<typename HashLocatorT, typename TextLocatorT> 
 		struct SqIndexType {
-			const std::vector<uint8_t> Data;
+		private:
+			// Exactly one of the following owns the index data.
+			const std::shared_ptr<const MemoryMappedFileRandomAccessStream> m_mapped;
+			const std::vector<uint8_t> m_buffer;
+
+		public:
+			const std::span<const uint8_t> Data;
 			const SqpackHeader& Header{};
 			const SqIndex::Header& IndexHeader{};
 			const std::span<const HashLocatorT> HashLocators;
@@ -33,17 +42,25 @@ namespace Sqex::Sqpack {
 			std::span<const SqIndex::PairHashLocator> GetPairHashLocators(uint32_t pathHash) const;
 			const SqIndex::LEDataLocator& GetLocator(uint32_t pathHash, uint32_t nameHash) const;
 
+		private:
+			// Maps (PathHash << 32 | NameHash) to index in HashLocators; empty if not requested.
+			const PerfectHashTable m_pairHashTable;
+
 		protected:
 			friend struct Reader;
-			SqIndex1Type(const RandomAccessStream& stream, bool strictVerify);
+			SqIndex1Type(const RandomAccessStream& stream, bool strictVerify, bool buildPerfectHashTable);
 		};
 
 		struct SqIndex2Type : SqIndexType<SqIndex::FullHashLocator, SqIndex::FullHashWithTextLocator> {
 			const SqIndex::LEDataLocator& GetLocator(uint32_t fullPathHash) const;
 
+		private:
+			// Maps FullPathHash to index in HashLocators; empty if not requested.
+			const PerfectHashTable m_fullHashTable;
+
 		protected:
 			friend struct Reader;
-			SqIndex2Type(const RandomAccessStream& stream, bool strictVerify);
+			SqIndex2Type(const RandomAccessStream& stream, bool strictVerify, bool buildPerfectHashTable);
 		};
 
 		struct SqDataType {
@@ -66,11 +83,12 @@ namespace Sqex::Sqpack {
 		std::vector<SqDataType> Data;
 		std::vector<std::pair<SqIndex::LEDataLocator, EntryInfoType>> EntryInfo;
 
-		Reader(std::shared_ptr<RandomAccessStream> indexStream1, std::shared_ptr<RandomAccessStream> indexStream2, std::vector<std::shared_ptr< RandomAccessStream>> dataStreams, bool strictVerify = false);
-		Reader(const std::filesystem::path& indexFile, bool strictVerify = false);
+		Reader(std::shared_ptr<RandomAccessStream> indexStream1, std::shared_ptr<RandomAccessStream> indexStream2, std::vector<std::shared_ptr< RandomAccessStream>> dataStreams, bool strictVerify = false, bool buildPerfectHashTables = false);
+		Reader(const std::filesystem::path& indexFile, bool strictVerify = false, bool buildPerfectHashTables = false);
 
 		[[nodiscard]] const SqIndex::LEDataLocator& GetLocator(const EntryPathSpec& pathSpec) const;
 		[[nodiscard]] std::shared_ptr<EntryProvider> GetEntryProvider(const EntryPathSpec& pathSpec, SqIndex::LEDataLocator locator, uint64_t allocation) const;
+		[[nodiscard]] std::shared_ptr<EntryProvider> GetEntryProvider(const EntryPathSpec& pathSpec, SqIndex::LEDataLocator locator) const;
 		[[nodiscard]] std::shared_ptr<EntryProvider> GetEntryProvider(const EntryPathSpec& pathSpec) const;
 		[[nodiscard]] std::shared_ptr<Sqex::RandomAccessStream> GetFile(const EntryPathSpec& pathSpec) const;
 		std::shared_ptr<RandomAccessStream> operator[](const EntryPathSpec& pathSpec) const;
@@ -81,6 +99,20 @@ namespace Sqex::Sqpack {
 		mutable std::mutex m_readersMtx;
 		mutable std::map<std::string, std::optional<Reader>> m_readers;
 
+		// Routing tables from hashes to the reader that owns the entry, built once all sqpack files are loaded.
+		struct Route {
+			uint32_t ReaderIndex;
+			SqIndex::LEDataLocator Locator;
+		};
+		mutable std::atomic_bool m_routesBuilt = false;
+		mutable std::vector<const Reader*> m_routeReaders;
+		mutable std::vector<Route> m_pairHashRoutes;
+		mutable std::vector<Route> m_fullHashRoutes;
+		mutable PerfectHashTable m_pairHashRouteTable;
+		mutable PerfectHashTable m_fullHashRouteTable;
+
+		void BuildRoutes() const;
+
 	public:
 		GameReader(std::filesystem::path gamePath);
 
@@ -24,7 +24,36 @@ void Sqex::Sqpack::StreamDecoder::ReadStreamState::AttemptSatisfyRequestOffset(c
 		throw CorruptDataException("Duplicate read on same region");
 }
 
+void Sqex::Sqpack::StreamDecoder::ReadStreamState::ProgressFromCachedBlock(const uint32_t requestOffset, const BlockCache::Block& block) {
+	// Callers may inspect the header of the block just processed.
+	if (ReadBuffer.size() < sizeof block.Header)
+		ReadBuffer.resize(sizeof block.Header);
+	std::copy_n(reinterpret_cast<const uint8_t*>(&block.Header), sizeof block.Header, ReadBuffer.begin());
+
+	AttemptSatisfyRequestOffset(requestOffset);
+	if (TargetBuffer.empty())
+		return;
+
+	RequestOffsetVerify += block.Header.DecompressedSize;
+
+	if (RelativeOffset < block.Data.size()) {
+		const auto available = std::min(TargetBuffer.size_bytes(), static_cast<size_t>(block.Data.size() - RelativeOffset));
+		std::copy_n(&block.Data[static_cast<size_t>(RelativeOffset)], available, TargetBuffer.begin());
+		TargetBuffer = TargetBuffer.subspan(available);
+		RelativeOffset = 0;
+	} else
+		RelativeOffset -= block.Data.size();
+}
+
 void Sqex::Sqpack::StreamDecoder::ReadStreamState::Progress(const uint32_t requestOffset, uint32_t blockOffset) {
+	const auto useCache = Backing && Backing->Stream;
+	if (useCache) {
+		if (const auto block = BlockCache::Instance().Find(Backing->Stream, Backing->Offset + blockOffset)) {
+			ProgressFromCachedBlock(requestOffset, *block);
+			return;
+		}
+	}
+
 	const auto read = std::span(&ReadBuffer[0], static_cast<size_t>(Underlying.ReadStreamPartial(blockOffset, &ReadBuffer[0], ReadBuffer.size())));
 	const auto& blockHeader = *reinterpret_cast<const SqData::BlockHeader*>(&ReadBuffer[0]);
 
@@ -34,6 +63,23 @@ void Sqex::Sqpack::StreamDecoder::ReadStreamState::Progress(const uint32_t reque
 		return;
 	}
 
+	if (useCache && blockHeader.CompressedSize != SqData::BlockHeader::CompressedSizeNotCompressed) {
+		if (sizeof blockHeader + blockHeader.CompressedSize > read.size_bytes())
+			throw CorruptDataException("Failed to read block");
+
+		auto block = std::make_shared<BlockCache::Block>();
+		block->Header = blockHeader;
+		block->Data.resize(blockHeader.DecompressedSize);
+		const auto buf = Inflater(read.subspan(sizeof blockHeader, blockHeader.CompressedSize), block->Data);
+		if (buf.size_bytes() != block->Data.size())
+			throw CorruptDataException(std::format("Expected {} bytes, inflated to {} bytes",
+				block->Data.size(), buf.size_bytes()));
+
+		ProgressFromCachedBlock(requestOffset, *block);
+		BlockCache::Instance().Insert(Backing->Stream, Backing->Offset + blockOffset, std::move(block));
+		return;
+	}
+
 	AttemptSatisfyRequestOffset(requestOffset);
 	if (TargetBuffer.empty())
 		return;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "XivAlexanderCommon/Sqex/Sqpack/BlockCache.h"
 #include "XivAlexanderCommon/Sqex/Sqpack/EntryProvider.h"
 #include "XivAlexanderCommon/Utils/ZlibWrapper.h"
 
@@ -13,6 +14,7 @@ namespace Sqex::Sqpack {
 			uint64_t RelativeOffset = 0;
 			uint32_t RequestOffsetVerify = 0;
 			bool HadCompressedBlocks = false;
+			const EntryProvider::BackingStreamView* Backing = nullptr;
 
 			ZlibReusableInflater Inflater{ -MAX_WBITS };
 
@@ -22,17 +24,20 @@ namespace Sqex::Sqpack {
 
 		private:
 			void AttemptSatisfyRequestOffset(const uint32_t requestOffset);
+			void ProgressFromCachedBlock(const uint32_t requestOffset, const BlockCache::Block& block);
 
 		public:
 			void Progress(const uint32_t requestOffset, uint32_t blockOffset);
 		};
 
 		const std::shared_ptr<const EntryProvider> m_stream;
+		const EntryProvider::BackingStreamView m_backing;
 		size_t m_maxBlockSize{};
 
 	public:
 		StreamDecoder(std::shared_ptr<const EntryProvider> stream)
 			: m_stream(std::move(stream))
+			, m_backing(m_stream->BackingStream())
 			, m_maxBlockSize(sizeof SqData::BlockHeader) {
 		}
 
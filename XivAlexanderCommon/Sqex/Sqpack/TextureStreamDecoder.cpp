@@ -48,6 +48,7 @@ uint64_t Sqex::Sqpack::TextureStreamDecoder::ReadStreamPartial(uint64_t offset,
 		.TargetBuffer = std::span(static_cast<uint8_t*>(buf), static_cast<size_t>(length)),
 		.ReadBuffer = std::vector<uint8_t>(m_maxBlockSize),
 		.RelativeOffset = offset,
+		.Backing = &m_backing,
 	};
 
 	if (info.RelativeOffset < m_head.size()) {
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Texture.h"
 
+#include <bit>
+
 void Sqex::Texture::to_json(nlohmann::json& j, const Format& o) {
 	switch (o) {
 		case Format::L8: j = "L8";
@@ -23,6 +25,12 @@ void Sqex::Texture::to_json(nlohmann::json& j, const Format& o) {
 			break;
 		case Format::DXT5: j = "DXT5";
 			break;
+		case Format::BC4: j = "BC4";
+			break;
+		case Format::BC5: j = "BC5";
+			break;
+		case Format::BC7: j = "BC7";
+			break;
 		case Format::R32F: j = "R32F";
 			break;
 		case Format::G16R16F: j = "G16R16F";
@@ -63,6 +71,12 @@ void Sqex::Texture::from_json(const nlohmann::json& j, Format& o) {
 			o = Format::DXT3;
 		else if (s == "DXT5")
 			o = Format::DXT5;
+		else if (s == "BC4")
+			o = Format::BC4;
+		else if (s == "BC5")
+			o = Format::BC5;
+		else if (s == "BC7")
+			o = Format::BC7;
 		else if (s == "R32F")
 			o = Format::R32F;
 		else if (s == "G16R16F")
@@ -89,6 +103,7 @@ size_t Sqex::Texture::RawDataLength(Format type, size_t width, size_t height, si
 
 		case Format::A4R4G4B4:
 		case Format::A1R5G5B5:
+		case Format::D16:
 			return width * height * depth * 2;
 
 		case Format::A8R8G8B8:
@@ -105,15 +120,71 @@ size_t Sqex::Texture::RawDataLength(Format type, size_t width, size_t height, si
 			return width * height * depth * 16;
 
 		case Format::DXT1:
+		case Format::BC4:
 			return depth * std::max<size_t>(1, ((width + 3) / 4)) * std::max<size_t>(1, ((height + 3) / 4)) * 8;
 
 		case Format::DXT3:
 		case Format::DXT5:
+		case Format::BC5:
+		case Format::BC7:
 			return depth * std::max<size_t>(1, ((width + 3) / 4)) * std::max<size_t>(1, ((height + 3) / 4)) * 16;
 
-		case Format::D16:
 		case Format::Unknown:
 		default:
 			throw std::invalid_argument("Unsupported type");
 	}
 }
+
+float Sqex::Texture::HalfToFloat(uint16_t value) {
+	const auto sign = static_cast<uint32_t>(value & 0x8000U) << 16;
+	const auto exponent = static_cast<uint32_t>(value >> 10) & 0x1FU;
+	auto mantissa = static_cast<uint32_t>(value) & 0x3FFU;
+
+	if (exponent == 0x1F)
+		return std::bit_cast<float>(sign | 0x7F800000U | (mantissa << 13));
+	if (exponent != 0)
+		return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+	if (mantissa == 0)
+		return std::bit_cast<float>(sign);
+
+	// subnormal half; every one of them is a normal float
+	auto floatExponent = 127U - 15U + 1U;
+	while (!(mantissa & 0x400U)) {
+		mantissa <<= 1;
+		--floatExponent;
+	}
+	return std::bit_cast<float>(sign | (floatExponent << 23) | ((mantissa & 0x3FFU) << 13));
+}
+
+uint16_t Sqex::Texture::FloatToHalf(float value) {
+	const auto bits = std::bit_cast<uint32_t>(value);
+	const auto sign = (bits >> 16) & 0x8000U;
+	const auto exponent = static_cast<int>((bits >> 23) & 0xFF);
+	auto mantissa = bits & 0x7FFFFFU;
+
+	if (exponent == 0xFF)
+		return static_cast<uint16_t>(sign | 0x7C00U | (mantissa ? 0x200U | (mantissa >> 13) : 0U));
+
+	const auto halfExponent = exponent - 127 + 15;
+	if (halfExponent >= 0x1F)
+		return static_cast<uint16_t>(sign | 0x7C00U);
+
+	uint32_t shift, half;
+	if (halfExponent <= 0) {
+		if (halfExponent < -10)
+			return static_cast<uint16_t>(sign);
+		mantissa |= 0x800000U;
+		shift = static_cast<uint32_t>(14 - halfExponent);
+		half = mantissa >> shift;
+	} else {
+		shift = 13;
+		half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> shift);
+	}
+
+	// round to nearest even; a carry out of the mantissa correctly bumps the exponent, up to infinity
+	const auto remainder = mantissa & ((1U << shift) - 1);
+	const auto halfway = 1U << (shift - 1);
+	if (remainder > halfway || (remainder == halfway && (half & 1)))
+		++half;
+	return static_cast<uint16_t>(sign | half);
+}
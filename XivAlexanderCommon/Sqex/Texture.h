@@ -18,6 +18,9 @@ namespace Sqex::Texture {
 		DXT1 = 13344,
 		DXT3 = 13360,
 		DXT5 = 13361,
+		BC4 = 24864,
+		BC5 = 25136,
+		BC7 = 25650,
 		D16 = 16704,
 	};
 
@@ -76,6 +79,10 @@ namespace Sqex::Texture {
 		}
 	};
 
+	// IEEE 754 binary16 conversions, including subnormals, infinities and NaNs; FloatToHalf rounds to nearest even.
+	float HalfToFloat(uint16_t value);
+	uint16_t FloatToHalf(float value);
+
 	union RGBAHHHH {
 		union Float {
 			float Value;
@@ -102,13 +109,7 @@ namespace Sqex::Texture {
 			} Bits;
 
 			operator float() const {
-				const auto v1 = Float{ .UintValue = (((UintValue & 0x8000U) << 16)
-							| (((UintValue & 0x7c00U) + 0x1C000U) << 13)
-							| ((UintValue & 0x03FFU) << 13)) }.Value;
-				const auto v2 = Float{ .HalfCompatibleBits = {Bits.Sign, Bits.Exponent - 15U + 127U, Bits.Mantissa, 0} }.Value;
-				if (v1 != v2)
-					throw std::runtime_error("test");
-				return v2;
+				return HalfToFloat(UintValue);
 			}
 		};
 
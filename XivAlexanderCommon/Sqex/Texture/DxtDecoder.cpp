@@ -0,0 +1,453 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Texture/DxtDecoder.h"
+
+#include <bit>
+#include <emmintrin.h>
+
+#include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
+
+// Color and alpha palettes follow Utils::Dxt, and thus DxtEncoder: interpolated values are rounded down.
+// BC7 follows the BPTC specification.
+// Pixels are stored in the byte order of A8R8G8B8, the same as every other format converted to RGBA8888:
+// blue goes to byte 0 (RGBA8888::R), and red goes to byte 2 (RGBA8888::B).
+
+namespace {
+	struct Bc7Mode {
+		uint8_t SubsetCount;
+		uint8_t PartitionBits;
+		uint8_t RotationBits;
+		uint8_t IndexSelectionBits;
+		uint8_t ColorBits;
+		uint8_t AlphaBits;
+		uint8_t EndpointPBits;
+		uint8_t SharedPBits;
+		uint8_t IndexBits;
+		uint8_t SecondaryIndexBits;
+	};
+
+	class Bc7BitReader {
+		uint64_t m_lo;
+		uint64_t m_hi;
+
+	public:
+		Bc7BitReader(const uint8_t* block) {
+			std::memcpy(&m_lo, block, 8);
+			std::memcpy(&m_hi, block + 8, 8);
+		}
+
+		uint32_t Read(uint32_t bits) {
+			if (!bits)
+				return 0;
+			const auto res = static_cast<uint32_t>(m_lo & ((1ULL << bits) - 1));
+			m_lo = (m_lo >> bits) | (m_hi << (64 - bits));
+			m_hi >>= bits;
+			return res;
+		}
+	};
+}
+
+static constexpr Bc7Mode Bc7Modes[8]{
+	{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+	{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+	{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+	{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+	{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+	{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+	{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+	{2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+static constexpr uint8_t Bc7Weights2[4]{ 0, 21, 43, 64 };
+static constexpr uint8_t Bc7Weights3[8]{ 0, 9, 18, 27, 37, 46, 55, 64 };
+static constexpr uint8_t Bc7Weights4[16]{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static constexpr uint8_t Bc7Partitions2[64][16]{
+	{0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1}, {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1},
+	{0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1}, {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 1, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 1}, {0, 0, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1},
+	{0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1}, {0, 0, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1},
+	{0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1},
+	{0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1},
+	{0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1, 1}, {0, 1, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0}, {0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0},
+	{0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0},
+	{0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0}, {0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 0, 1},
+	{0, 0, 1, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0}, {0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 0, 0},
+	{0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0}, {0, 0, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 1, 1, 0, 0},
+	{0, 0, 0, 1, 0, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0}, {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
+	{0, 1, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 0}, {0, 0, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0},
+	{0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1}, {0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1},
+	{0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0}, {0, 0, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0},
+	{0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0}, {0, 1, 0, 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0},
+	{0, 1, 1, 0, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1}, {0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1, 0, 0, 1, 0, 1},
+	{0, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 0}, {0, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 0},
+	{0, 0, 1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1, 0, 0}, {0, 0, 1, 1, 1, 0, 1, 1, 1, 1, 0, 1, 1, 1, 0, 0},
+	{0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0}, {0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 1, 1},
+	{0, 1, 1, 0, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1}, {0, 0, 0, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0},
+	{0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0}, {0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0, 0, 0, 0},
+	{0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0}, {0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1, 0, 0},
+	{0, 1, 1, 0, 1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 1}, {0, 0, 1, 1, 0, 1, 1, 0, 1, 1, 0, 0, 1, 0, 0, 1},
+	{0, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0}, {0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 0, 1, 1, 0},
+	{0, 1, 1, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 0, 0, 1}, {0, 1, 1, 0, 0, 0, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1},
+	{0, 1, 1, 1, 1, 1, 1, 0, 1, 0, 0, 0, 0, 0, 0, 1}, {0, 0, 0, 1, 1, 0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1},
+	{0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1}, {0, 0, 1, 1, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0},
+	{0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0}, {0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 1, 1, 0, 1, 1, 1},
+};
+
+static constexpr uint8_t Bc7Partitions3[64][16]{
+	{0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2}, {0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1},
+	{0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1}, {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2}, {0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2},
+	{0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1}, {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+	{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2}, {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2},
+	{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2},
+	{0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2}, {0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2},
+	{0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2}, {0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0},
+	{0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2}, {0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0},
+	{0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2}, {0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1},
+	{0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2}, {0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1},
+	{0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2}, {0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0},
+	{0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0}, {0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2},
+	{0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0}, {0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1},
+	{0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2}, {0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2},
+	{0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1}, {0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1},
+	{0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2}, {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1},
+	{0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2}, {0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0},
+	{0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0}, {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0},
+	{0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0}, {0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1},
+	{0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1}, {0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+	{0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1}, {0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2},
+	{0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1}, {0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1},
+	{0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1}, {0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1},
+	{0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2}, {0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1},
+	{0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2}, {0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2},
+	{0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2}, {0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2},
+	{0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2}, {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2},
+	{0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2},
+	{0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2},
+	{0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1}, {0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2},
+	{0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2}, {0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0},
+};
+
+// Pixel whose index of the second subset, in a two subset partition, is stored with its top bit omitted.
+static constexpr uint8_t Bc7Anchors2[64]{
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+	6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+// Same, for the second and third subsets of a three subset partition.
+static constexpr uint8_t Bc7Anchors3Second[64]{
+	3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+	3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+	8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+	3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+};
+static constexpr uint8_t Bc7Anchors3Third[64]{
+	15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+	15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+	15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+	15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+};
+
+static uint32_t PackRGBA(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+	return b | (g << 8) | (r << 16) | (a << 24);
+}
+
+// Builds the four entry palette of a DXT color block, with interpolated entries computed on all channels at once.
+static void DecodeColorPalette(const uint8_t* block, bool allowThreeColor, uint32_t(&palette)[4]) {
+	const auto color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+	const auto color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+
+	// 5 and 6 bit channels expand the same way Utils::DecompressBlockDXT1 does.
+	const auto expand = [](uint32_t value, uint32_t bits) {
+		const auto temp = value * 255 + (1U << (bits - 1));
+		return ((temp >> bits) + temp) >> bits;
+	};
+	const auto e = _mm_setr_epi16(
+		static_cast<short>(expand(color0 & 0x1F, 5)), static_cast<short>(expand((color0 >> 5) & 0x3F, 6)), static_cast<short>(expand(color0 >> 11, 5)), 255,
+		static_cast<short>(expand(color1 & 0x1F, 5)), static_cast<short>(expand((color1 >> 5) & 0x3F, 6)), static_cast<short>(expand(color1 >> 11, 5)), 255);
+	const auto e0 = _mm_unpacklo_epi64(e, e);
+	const auto e1 = _mm_unpackhi_epi64(e, e);
+
+	__m128i interpolated;
+	if (color0 > color1 || !allowThreeColor) {
+		// floor(x / 3) == x * 21846 >> 16 for x < 32768; low half is (2 * e0 + e1) / 3, high half is (e0 + 2 * e1) / 3.
+		const auto sum = _mm_add_epi16(_mm_add_epi16(e0, e1), _mm_unpacklo_epi64(e0, e1));
+		interpolated = _mm_mulhi_epu16(sum, _mm_set1_epi16(21846));
+	} else {
+		// low half is (e0 + e1) / 2; high half is transparent black.
+		interpolated = _mm_unpacklo_epi64(_mm_srli_epi16(_mm_add_epi16(e0, e1), 1), _mm_setzero_si128());
+	}
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(palette), _mm_packus_epi16(e, interpolated));
+}
+
+static void DecodeColorBlock(const uint8_t* block, bool allowThreeColor, Sqex::Texture::RGBA8888* pixels) {
+	uint32_t palette[4];
+	DecodeColorPalette(block, allowThreeColor, palette);
+	const auto indices = static_cast<uint32_t>(block[4] | (block[5] << 8) | (block[6] << 16) | (block[7] << 24));
+	for (size_t i = 0; i < 16; ++i)
+		pixels[i].Value = palette[(indices >> (2 * i)) & 3];
+}
+
+// Decodes a DXT5 alpha or BC4 block into 16 values.
+static void DecodeInterpolatedBlock(const uint8_t* block, uint8_t(&values)[16]) {
+	const int value0 = block[0], value1 = block[1];
+	uint8_t palette[8]{ block[0], block[1] };
+	if (value0 > value1) {
+		for (auto i = 2; i < 8; ++i)
+			palette[i] = static_cast<uint8_t>(((8 - i) * value0 + (i - 1) * value1) / 7);
+	} else {
+		for (auto i = 2; i < 6; ++i)
+			palette[i] = static_cast<uint8_t>(((6 - i) * value0 + (i - 1) * value1) / 5);
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint64_t indices = 0;
+	for (size_t i = 0; i < 6; ++i)
+		indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+	for (size_t i = 0; i < 16; ++i)
+		values[i] = palette[(indices >> (3 * i)) & 7];
+}
+
+// Interpolates 1 << bits entries between two RGBA endpoints, two entries per vector.
+static void InterpolateBc7Palette(const uint8_t(&e0)[4], const uint8_t(&e1)[4], uint32_t bits, uint32_t* palette) {
+	const auto& weights = bits == 2 ? Bc7Weights2 : bits == 3 ? Bc7Weights3 : Bc7Weights4;
+	const auto zero = _mm_setzero_si128();
+	auto v0 = _mm_cvtsi32_si128(static_cast<int>(PackRGBA(e0[0], e0[1], e0[2], e0[3])));
+	auto v1 = _mm_cvtsi32_si128(static_cast<int>(PackRGBA(e1[0], e1[1], e1[2], e1[3])));
+	v0 = _mm_unpacklo_epi8(v0, zero);
+	v0 = _mm_unpacklo_epi64(v0, v0);
+	v1 = _mm_unpacklo_epi8(v1, zero);
+	v1 = _mm_unpacklo_epi64(v1, v1);
+	const auto sixtyFour = _mm_set1_epi16(64);
+	const auto half = _mm_set1_epi16(32);
+	for (size_t i = 0, count = size_t{ 1 } << bits; i < count; i += 2) {
+		const auto w = _mm_unpacklo_epi64(_mm_set1_epi16(weights[i]), _mm_set1_epi16(weights[i + 1]));
+		auto v = _mm_add_epi16(_mm_mullo_epi16(v0, _mm_sub_epi16(sixtyFour, w)), _mm_mullo_epi16(v1, w));
+		v = _mm_srli_epi16(_mm_add_epi16(v, half), 6);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(palette + i), _mm_packus_epi16(v, v));
+	}
+}
+
+static void DecodeBc7Block(const uint8_t* block, Sqex::Texture::RGBA8888* pixels) {
+	if (!block[0]) {
+		// Reserved mode; decodes to transparent black.
+		for (size_t i = 0; i < 16; ++i)
+			pixels[i].Value = 0;
+		return;
+	}
+
+	const auto modeIndex = static_cast<uint32_t>(std::countr_zero(block[0]));
+	const auto& mode = Bc7Modes[modeIndex];
+	Bc7BitReader reader(block);
+	reader.Read(modeIndex + 1);
+
+	const auto partition = reader.Read(mode.PartitionBits);
+	const auto rotation = reader.Read(mode.RotationBits);
+	const auto indexSelection = reader.Read(mode.IndexSelectionBits);
+
+	const auto endpointCount = mode.SubsetCount * 2U;
+	uint32_t endpoints[6][4]{};
+	for (size_t c = 0; c < 3; ++c) {
+		for (size_t e = 0; e < endpointCount; ++e)
+			endpoints[e][c] = reader.Read(mode.ColorBits);
+	}
+	if (mode.AlphaBits) {
+		for (size_t e = 0; e < endpointCount; ++e)
+			endpoints[e][3] = reader.Read(mode.AlphaBits);
+	}
+
+	auto colorBits = static_cast<uint32_t>(mode.ColorBits);
+	auto alphaBits = static_cast<uint32_t>(mode.AlphaBits);
+	if (mode.EndpointPBits || mode.SharedPBits) {
+		uint32_t pBits[6]{};
+		if (mode.EndpointPBits) {
+			for (size_t e = 0; e < endpointCount; ++e)
+				pBits[e] = reader.Read(1);
+		} else {
+			for (size_t s = 0; s < mode.SubsetCount; ++s)
+				pBits[s * 2] = pBits[s * 2 + 1] = reader.Read(1);
+		}
+		for (size_t e = 0; e < endpointCount; ++e) {
+			for (auto& v : endpoints[e])
+				v = (v << 1) | pBits[e];
+		}
+		++colorBits;
+		if (alphaBits)
+			++alphaBits;
+	}
+
+	uint8_t expanded[6][4];
+	for (size_t e = 0; e < endpointCount; ++e) {
+		for (size_t c = 0; c < 4; ++c) {
+			const auto bits = c < 3 ? colorBits : alphaBits;
+			if (!bits)
+				expanded[e][c] = 255;
+			else
+				expanded[e][c] = static_cast<uint8_t>((endpoints[e][c] << (8 - bits)) | (endpoints[e][c] >> (2 * bits - 8)));
+		}
+	}
+
+	const auto subsets = mode.SubsetCount == 1 ? nullptr : mode.SubsetCount == 2 ? Bc7Partitions2[partition] : Bc7Partitions3[partition];
+	const auto isAnchor = [&](size_t i) {
+		if (i == 0)
+			return true;
+		if (mode.SubsetCount == 2)
+			return i == Bc7Anchors2[partition];
+		if (mode.SubsetCount == 3)
+			return i == Bc7Anchors3Second[partition] || i == Bc7Anchors3Third[partition];
+		return false;
+	};
+
+	uint8_t indices[16], secondaryIndices[16]{};
+	for (size_t i = 0; i < 16; ++i)
+		indices[i] = static_cast<uint8_t>(reader.Read(mode.IndexBits - (isAnchor(i) ? 1 : 0)));
+	if (mode.SecondaryIndexBits) {
+		for (size_t i = 0; i < 16; ++i)
+			secondaryIndices[i] = static_cast<uint8_t>(reader.Read(mode.SecondaryIndexBits - (i == 0 ? 1 : 0)));
+	}
+
+	uint32_t palettes[3][16];
+	for (size_t s = 0; s < mode.SubsetCount; ++s)
+		InterpolateBc7Palette(expanded[s * 2], expanded[s * 2 + 1], mode.IndexBits, palettes[s]);
+
+	if (!mode.SecondaryIndexBits) {
+		for (size_t i = 0; i < 16; ++i)
+			pixels[i].Value = palettes[subsets ? subsets[i] : 0][indices[i]];
+	} else {
+		// Single subset; color and alpha take separate indices, and indexSelection swaps which set each takes.
+		uint32_t secondaryPalette[16];
+		InterpolateBc7Palette(expanded[0], expanded[1], mode.SecondaryIndexBits, secondaryPalette);
+		for (size_t i = 0; i < 16; ++i) {
+			const auto primary = palettes[0][indices[i]];
+			const auto secondary = secondaryPalette[secondaryIndices[i]];
+			if (indexSelection)
+				pixels[i].Value = (secondary & 0x00FFFFFFU) | (primary & 0xFF000000U);
+			else
+				pixels[i].Value = (primary & 0x00FFFFFFU) | (secondary & 0xFF000000U);
+		}
+	}
+
+	if (rotation) {
+		// Rotation 1 swaps alpha with red, which is stored in RGBA8888::B; 3 swaps it with blue, in RGBA8888::R.
+		for (size_t i = 0; i < 16; ++i) {
+			auto& p = pixels[i];
+			const auto a = p.A;
+			switch (rotation) {
+				case 1:
+					p.A = p.B;
+					p.B = a;
+					break;
+				case 2:
+					p.A = p.G;
+					p.G = a;
+					break;
+				case 3:
+					p.A = p.R;
+					p.R = a;
+					break;
+			}
+		}
+	}
+}
+
+bool Sqex::Texture::IsBlockCompressed(Format type) {
+	switch (type) {
+		case Format::DXT1:
+		case Format::DXT3:
+		case Format::DXT5:
+		case Format::BC4:
+		case Format::BC5:
+		case Format::BC7:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void Sqex::Texture::DecodeDxtBlock(Format type, const uint8_t* block, RGBA8888* pixels) {
+	switch (type) {
+		case Format::DXT1:
+			DecodeColorBlock(block, true, pixels);
+			break;
+
+		case Format::DXT3:
+			DecodeColorBlock(block + 8, false, pixels);
+			for (size_t i = 0; i < 16; ++i)
+				pixels[i].A = 17 * ((block[i / 2] >> (4 * (i % 2))) & 0xF);
+			break;
+
+		case Format::DXT5:
+		{
+			uint8_t alphas[16];
+			DecodeColorBlock(block + 8, false, pixels);
+			DecodeInterpolatedBlock(block, alphas);
+			for (size_t i = 0; i < 16; ++i)
+				pixels[i].A = alphas[i];
+			break;
+		}
+
+		case Format::BC4:
+		{
+			uint8_t reds[16];
+			DecodeInterpolatedBlock(block, reds);
+			for (size_t i = 0; i < 16; ++i)
+				pixels[i].Value = PackRGBA(reds[i], 0, 0, 255);
+			break;
+		}
+
+		case Format::BC5:
+		{
+			uint8_t reds[16], greens[16];
+			DecodeInterpolatedBlock(block, reds);
+			DecodeInterpolatedBlock(block + 8, greens);
+			for (size_t i = 0; i < 16; ++i)
+				pixels[i].Value = PackRGBA(reds[i], greens[i], 0, 255);
+			break;
+		}
+
+		case Format::BC7:
+			DecodeBc7Block(block, pixels);
+			break;
+
+		default:
+			throw std::invalid_argument("Unsupported type");
+	}
+}
+
+void Sqex::Texture::DecodeDxt(Format type, size_t width, size_t height, size_t depth, std::span<const uint8_t> blocks, std::span<RGBA8888> pixels) {
+	if (!IsBlockCompressed(type))
+		throw std::invalid_argument("Unsupported type");
+	if (blocks.size() < RawDataLength(type, width, height, depth))
+		throw std::invalid_argument("blocks is smaller than RawDataLength(type, width, height, depth)");
+	if (pixels.size() < width * height * depth)
+		throw std::invalid_argument("pixels is smaller than width * height * depth");
+	if (!width || !height || !depth)
+		return;
+
+	const auto cbBlock = RawDataLength(type, 1, 1, 1);
+	const auto blockCountX = (width + 3) / 4;
+	const auto blockCountY = (height + 3) / 4;
+
+	Utils::Win32::ParallelFor(blockCountY * depth, [&](size_t rowIndex) {
+		const auto layer = rowIndex / blockCountY;
+		const auto y0 = rowIndex % blockCountY * 4;
+		const auto target = pixels.subspan(layer * width * height, width * height);
+		auto source = &blocks[rowIndex * blockCountX * cbBlock];
+
+		RGBA8888 blockPixels[16];
+		for (size_t bx = 0; bx < blockCountX; ++bx, source += cbBlock) {
+			DecodeDxtBlock(type, source, blockPixels);
+			const auto x0 = bx * 4;
+			const auto w = std::min<size_t>(4, width - x0);
+			for (size_t dy = 0, h = std::min<size_t>(4, height - y0); dy < h; ++dy)
+				std::copy_n(&blockPixels[dy * 4], w, &target[(y0 + dy) * width + x0]);
+		}
+	});
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "XivAlexanderCommon/Sqex/Texture.h"
+
+namespace Sqex::Texture {
+	// Whether type stores 4x4 pixel blocks, which DecodeDxt can decode.
+	bool IsBlockCompressed(Format type);
+
+	// Decodes one block of DXT1, DXT3, DXT5, BC4, BC5 or BC7 into 16 pixels in row-major order, in the byte order of A8R8G8B8.
+	// BC4 and BC5 decode into the red and green channels, with blue at 0 and opacity at 255.
+	void DecodeDxtBlock(Format type, const uint8_t* block, RGBA8888* pixels);
+
+	// Decodes RawDataLength(type, width, height, depth) bytes of blocks into width * height * depth pixels, decoding rows of blocks in parallel.
+	void DecodeDxt(Format type, size_t width, size_t height, size_t depth, std::span<const uint8_t> blocks, std::span<RGBA8888> pixels);
+}
@@ -0,0 +1,465 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Texture/DxtEncoder.h"
+
+#include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
+
+namespace {
+	struct Vec3 {
+		float R{}, G{}, B{};
+
+		Vec3 operator+(const Vec3& r) const { return { R + r.R, G + r.G, B + r.B }; }
+		Vec3 operator-(const Vec3& r) const { return { R - r.R, G - r.G, B - r.B }; }
+		Vec3 operator*(float r) const { return { R * r, G * r, B * r }; }
+		Vec3& operator+=(const Vec3& r) { return *this = *this + r; }
+		[[nodiscard]] float Dot(const Vec3& r) const { return R * r.R + G * r.G + B * r.B; }
+	};
+
+	struct ColorBlock {
+		int Colors[16][3]{};
+		bool Transparent[16]{};
+		bool AnyTransparent = false;
+
+		// Colors of pixels that are not transparent, which are the only ones the endpoints need to fit.
+		Vec3 Points[16]{};
+		size_t PointCount = 0;
+	};
+
+	struct ColorCandidate {
+		uint16_t Color0 = 0;
+		uint16_t Color1 = 0;
+		uint32_t Indices = 0;
+		uint32_t Error = UINT32_MAX;
+	};
+}
+
+static uint16_t QuantizeTo565(const Vec3& c) {
+	const auto r = static_cast<uint16_t>(std::lround(std::clamp(c.R, 0.f, 255.f) * 31.f / 255.f));
+	const auto g = static_cast<uint16_t>(std::lround(std::clamp(c.G, 0.f, 255.f) * 63.f / 255.f));
+	const auto b = static_cast<uint16_t>(std::lround(std::clamp(c.B, 0.f, 255.f) * 31.f / 255.f));
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+// Same expansion Utils::DecompressBlockDXT1 uses.
+static void Expand565(uint16_t v, int(&rgb)[3]) {
+	auto temp = (v >> 11) * 255 + 16;
+	rgb[0] = (temp / 32 + temp) / 32;
+	temp = ((v >> 5) & 0x3F) * 255 + 32;
+	rgb[1] = (temp / 64 + temp) / 64;
+	temp = (v & 0x1F) * 255 + 16;
+	rgb[2] = (temp / 32 + temp) / 32;
+}
+
+static Vec3 SnapTo565(const Vec3& c) {
+	int rgb[3];
+	Expand565(QuantizeTo565(c), rgb);
+	return { static_cast<float>(rgb[0]), static_cast<float>(rgb[1]), static_cast<float>(rgb[2]) };
+}
+
+// Chooses the closest palette entry for every pixel; transparent pixels, and only those, take index 3 of the three color palette.
+static ColorCandidate EvaluateEndpoints(const ColorBlock& block, uint16_t color0, uint16_t color1, bool threeColor) {
+	if (threeColor ? color0 > color1 : color0 < color1)
+		std::swap(color0, color1);
+
+	int palette[4][3];
+	Expand565(color0, palette[0]);
+	Expand565(color1, palette[1]);
+	auto paletteSize = 4;
+	if (color0 == color1) {
+		// Decoders take this as the three color palette, so stick to the one color both palettes agree on.
+		paletteSize = 1;
+	} else if (threeColor) {
+		for (size_t i = 0; i < 3; ++i)
+			palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+		paletteSize = 3;
+	} else {
+		for (size_t i = 0; i < 3; ++i) {
+			palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+			palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+		}
+	}
+
+	ColorCandidate res{ .Color0 = color0, .Color1 = color1, .Error = 0 };
+	for (size_t i = 0; i < 16; ++i) {
+		uint32_t index = 0;
+		if (block.Transparent[i])
+			index = 3;
+		else {
+			auto bestError = INT_MAX;
+			for (auto j = 0; j < paletteSize; ++j) {
+				const auto dr = block.Colors[i][0] - palette[j][0];
+				const auto dg = block.Colors[i][1] - palette[j][1];
+				const auto db = block.Colors[i][2] - palette[j][2];
+				if (const auto error = dr * dr + dg * dg + db * db; error < bestError) {
+					bestError = error;
+					index = j;
+				}
+			}
+			res.Error += bestError;
+		}
+		res.Indices |= index << (2 * i);
+	}
+	return res;
+}
+
+static Vec3 PrincipalAxis(const ColorBlock& block) {
+	Vec3 mean;
+	for (size_t i = 0; i < block.PointCount; ++i)
+		mean += block.Points[i];
+	mean = mean * (1.f / static_cast<float>(block.PointCount));
+
+	float cov[6]{};  // rr, rg, rb, gg, gb, bb
+	for (size_t i = 0; i < block.PointCount; ++i) {
+		const auto d = block.Points[i] - mean;
+		cov[0] += d.R * d.R;
+		cov[1] += d.R * d.G;
+		cov[2] += d.R * d.B;
+		cov[3] += d.G * d.G;
+		cov[4] += d.G * d.B;
+		cov[5] += d.B * d.B;
+	}
+
+	Vec3 axis{ 1.f, 1.f, 1.f };
+	for (auto iteration = 0; iteration < 8; ++iteration) {
+		const Vec3 next{
+			axis.R * cov[0] + axis.G * cov[1] + axis.B * cov[2],
+			axis.R * cov[1] + axis.G * cov[3] + axis.B * cov[4],
+			axis.R * cov[2] + axis.G * cov[4] + axis.B * cov[5],
+		};
+		const auto norm = std::max({ std::abs(next.R), std::abs(next.G), std::abs(next.B) });
+		if (norm < 1e-6f)
+			break;
+		axis = next * (1.f / norm);
+	}
+	return axis;
+}
+
+static void RangeFit(const ColorBlock& block, const Vec3& axis, Vec3& start, Vec3& end) {
+	auto minDot = FLT_MAX, maxDot = -FLT_MAX;
+	for (size_t i = 0; i < block.PointCount; ++i) {
+		const auto d = block.Points[i].Dot(axis);
+		if (d < minDot) {
+			minDot = d;
+			end = block.Points[i];
+		}
+		if (d > maxDot) {
+			maxDot = d;
+			start = block.Points[i];
+		}
+	}
+}
+
+// Solves for the endpoints that best reproduce the points, given how much of each endpoint every point takes.
+static bool SolveEndpoints(const Vec3& alphaX, const Vec3& betaX, float alpha2, float beta2, float alphaBeta, Vec3& start, Vec3& end) {
+	const auto det = alpha2 * beta2 - alphaBeta * alphaBeta;
+	if (std::abs(det) < 1e-6f)
+		return false;
+	start = (alphaX * beta2 - betaX * alphaBeta) * (1.f / det);
+	end = (betaX * alpha2 - alphaX * alphaBeta) * (1.f / det);
+	return true;
+}
+
+static ColorCandidate RefineByLeastSquares(const ColorBlock& block, ColorCandidate best, bool threeColor, int iterations) {
+	static constexpr float FourColorWeights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+	static constexpr float ThreeColorWeights[4] = { 1.f, 0.f, 1.f / 2.f, 0.f };
+	const auto& weights = threeColor ? ThreeColorWeights : FourColorWeights;
+
+	for (auto iteration = 0; iteration < iterations; ++iteration) {
+		Vec3 alphaX, betaX;
+		float alpha2 = 0, beta2 = 0, alphaBeta = 0;
+		for (size_t i = 0; i < 16; ++i) {
+			if (block.Transparent[i])
+				continue;
+			const auto alpha = weights[(best.Indices >> (2 * i)) & 3];
+			const auto beta = 1.f - alpha;
+			const Vec3 x{ static_cast<float>(block.Colors[i][0]), static_cast<float>(block.Colors[i][1]), static_cast<float>(block.Colors[i][2]) };
+			alphaX += x * alpha;
+			betaX += x * beta;
+			alpha2 += alpha * alpha;
+			beta2 += beta * beta;
+			alphaBeta += alpha * beta;
+		}
+
+		Vec3 start, end;
+		if (!SolveEndpoints(alphaX, betaX, alpha2, beta2, alphaBeta, start, end))
+			break;
+		const auto candidate = EvaluateEndpoints(block, QuantizeTo565(start), QuantizeTo565(end), threeColor);
+		if (candidate.Error >= best.Error)
+			break;
+		best = candidate;
+	}
+	return best;
+}
+
+static ColorCandidate ClusterFit(const ColorBlock& block, const Vec3& axis, bool threeColor) {
+	const auto n = block.PointCount;
+	size_t order[16];
+	float dots[16];
+	for (size_t i = 0; i < n; ++i) {
+		order[i] = i;
+		dots[i] = block.Points[i].Dot(axis);
+	}
+	std::sort(order, order + n, [&](size_t l, size_t r) { return dots[l] < dots[r]; });
+
+	// prefix[i] is the sum of the first i points in projection order, from the end of the axis towards its start.
+	Vec3 prefix[17];
+	for (size_t i = 0; i < n; ++i)
+		prefix[i + 1] = prefix[i] + block.Points[order[i]];
+	const auto sumOf = [&](size_t from, size_t to) { return prefix[to] - prefix[from]; };
+
+	Vec3 bestStart, bestEnd;
+	auto bestError = FLT_MAX;
+	const auto tryEndpoints = [&](const Vec3& alphaX, const Vec3& betaX, float alpha2, float beta2, float alphaBeta) {
+		Vec3 start, end;
+		if (!SolveEndpoints(alphaX, betaX, alpha2, beta2, alphaBeta, start, end))
+			return;
+
+		// Squared error of the fit, up to the constant sum of squared points, measured on what the endpoints will quantize to.
+		start = SnapTo565(start);
+		end = SnapTo565(end);
+		const auto error = start.Dot(start) * alpha2 + end.Dot(end) * beta2 + 2.f * start.Dot(end) * alphaBeta - 2.f * start.Dot(alphaX) - 2.f * end.Dot(betaX);
+		if (error < bestError) {
+			bestError = error;
+			bestStart = start;
+			bestEnd = end;
+		}
+	};
+
+	if (threeColor) {
+		// [0, i) takes end, [i, j) the midpoint, [j, n) start.
+		for (size_t i = 0; i <= n; ++i) {
+			for (size_t j = i; j <= n; ++j) {
+				const auto mid = sumOf(i, j);
+				const auto midCount = static_cast<float>(j - i);
+				tryEndpoints(
+					sumOf(j, n) + mid * 0.5f,
+					sumOf(0, i) + mid * 0.5f,
+					static_cast<float>(n - j) + midCount * 0.25f,
+					static_cast<float>(i) + midCount * 0.25f,
+					midCount * 0.25f);
+			}
+		}
+	} else {
+		// [0, i) takes end, [i, j) one third of start, [j, k) two thirds of start, [k, n) start.
+		for (size_t i = 0; i <= n; ++i) {
+			for (size_t j = i; j <= n; ++j) {
+				const auto third = sumOf(i, j);
+				const auto thirdCount = static_cast<float>(j - i);
+				for (size_t k = j; k <= n; ++k) {
+					const auto twoThirds = sumOf(j, k);
+					const auto twoThirdsCount = static_cast<float>(k - j);
+					tryEndpoints(
+						sumOf(k, n) + twoThirds * (2.f / 3.f) + third * (1.f / 3.f),
+						sumOf(0, i) + third * (2.f / 3.f) + twoThirds * (1.f / 3.f),
+						static_cast<float>(n - k) + twoThirdsCount * (4.f / 9.f) + thirdCount * (1.f / 9.f),
+						static_cast<float>(i) + thirdCount * (4.f / 9.f) + twoThirdsCount * (1.f / 9.f),
+						(thirdCount + twoThirdsCount) * (2.f / 9.f));
+				}
+			}
+		}
+	}
+
+	if (bestError == FLT_MAX)
+		return {};
+	return EvaluateEndpoints(block, QuantizeTo565(bestStart), QuantizeTo565(bestEnd), threeColor);
+}
+
+static void EncodeColorBlock(const Sqex::Texture::RGBA8888* pixels, uint8_t* out, Sqex::Texture::DxtQuality quality, bool allowTransparency) {
+	using Sqex::Texture::DxtQuality;
+
+	// Pixels are in the byte order of A8R8G8B8, so RGBA8888::B holds red and RGBA8888::R holds blue.
+	ColorBlock block;
+	for (size_t i = 0; i < 16; ++i) {
+		block.Colors[i][0] = static_cast<int>(pixels[i].B);
+		block.Colors[i][1] = static_cast<int>(pixels[i].G);
+		block.Colors[i][2] = static_cast<int>(pixels[i].R);
+		if (allowTransparency && pixels[i].A < 128) {
+			block.Transparent[i] = true;
+			block.AnyTransparent = true;
+		} else {
+			block.Points[block.PointCount++] = {
+				static_cast<float>(pixels[i].B),
+				static_cast<float>(pixels[i].G),
+				static_cast<float>(pixels[i].R),
+			};
+		}
+	}
+
+	ColorCandidate best;
+	if (!block.PointCount) {
+		best = EvaluateEndpoints(block, 0, 0, true);
+	} else {
+		const auto axis = PrincipalAxis(block);
+		const auto fit = [&](bool threeColor) {
+			Vec3 start, end;
+			RangeFit(block, axis, start, end);
+			auto res = EvaluateEndpoints(block, QuantizeTo565(start), QuantizeTo565(end), threeColor);
+			if (quality >= DxtQuality::High) {
+				if (const auto clustered = ClusterFit(block, axis, threeColor); clustered.Error < res.Error)
+					res = clustered;
+			}
+			if (quality >= DxtQuality::Normal)
+				res = RefineByLeastSquares(block, res, threeColor, quality >= DxtQuality::High ? 4 : 2);
+			return res;
+		};
+
+		best = fit(block.AnyTransparent);
+		if (allowTransparency && !block.AnyTransparent && quality >= DxtQuality::High) {
+			if (const auto threeColor = fit(true); threeColor.Error < best.Error)
+				best = threeColor;
+		}
+	}
+
+	out[0] = static_cast<uint8_t>(best.Color0);
+	out[1] = static_cast<uint8_t>(best.Color0 >> 8);
+	out[2] = static_cast<uint8_t>(best.Color1);
+	out[3] = static_cast<uint8_t>(best.Color1 >> 8);
+	for (size_t i = 0; i < 4; ++i)
+		out[4 + i] = static_cast<uint8_t>(best.Indices >> (8 * i));
+}
+
+static void EncodeExplicitAlphaBlock(const Sqex::Texture::RGBA8888* pixels, uint8_t* out) {
+	for (size_t i = 0; i < 8; ++i) {
+		const auto lo = (pixels[i * 2].A * 15 + 127) / 255;
+		const auto hi = (pixels[i * 2 + 1].A * 15 + 127) / 255;
+		out[i] = static_cast<uint8_t>(lo | (hi << 4));
+	}
+}
+
+// Same palette Utils::DecompressBlockDXT5 uses: eight interpolated values if alpha0 > alpha1, otherwise six and then 0 and 255.
+static uint32_t EvaluateAlphaEndpoints(const uint8_t(&alphas)[16], uint8_t alpha0, uint8_t alpha1, uint64_t& indices) {
+	int palette[8]{ alpha0, alpha1 };
+	if (alpha0 > alpha1) {
+		for (auto i = 2; i < 8; ++i)
+			palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+	} else {
+		for (auto i = 2; i < 6; ++i)
+			palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint32_t error = 0;
+	indices = 0;
+	for (size_t i = 0; i < 16; ++i) {
+		uint64_t bestIndex = 0;
+		auto bestError = INT_MAX;
+		for (auto j = 0; j < 8; ++j) {
+			const auto d = alphas[i] - palette[j];
+			if (d * d < bestError) {
+				bestError = d * d;
+				bestIndex = j;
+			}
+		}
+		error += bestError;
+		indices |= bestIndex << (3 * i);
+	}
+	return error;
+}
+
+static void EncodeInterpolatedAlphaBlock(const Sqex::Texture::RGBA8888* pixels, uint8_t* out, Sqex::Texture::DxtQuality quality) {
+	using Sqex::Texture::DxtQuality;
+
+	uint8_t alphas[16];
+	uint8_t minAlpha = 255, maxAlpha = 0;
+	uint8_t minInner = 255, maxInner = 0;  // excluding 0 and 255, which the six value palette has for free
+	for (size_t i = 0; i < 16; ++i) {
+		alphas[i] = static_cast<uint8_t>(pixels[i].A);
+		minAlpha = std::min(minAlpha, alphas[i]);
+		maxAlpha = std::max(maxAlpha, alphas[i]);
+		if (alphas[i] != 0 && alphas[i] != 255) {
+			minInner = std::min(minInner, alphas[i]);
+			maxInner = std::max(maxInner, alphas[i]);
+		}
+	}
+	if (minInner > maxInner)
+		minInner = maxInner = 0;
+
+	uint8_t best0 = maxAlpha, best1 = minAlpha;
+	uint64_t bestIndices;
+	auto bestError = EvaluateAlphaEndpoints(alphas, best0, best1, bestIndices);
+	const auto tryEndpoints = [&](int alpha0, int alpha1) {
+		if (alpha0 < 0 || alpha0 > 255 || alpha1 < 0 || alpha1 > 255)
+			return;
+		uint64_t indices;
+		if (const auto error = EvaluateAlphaEndpoints(alphas, static_cast<uint8_t>(alpha0), static_cast<uint8_t>(alpha1), indices); error < bestError) {
+			bestError = error;
+			bestIndices = indices;
+			best0 = static_cast<uint8_t>(alpha0);
+			best1 = static_cast<uint8_t>(alpha1);
+		}
+	};
+
+	if (quality >= DxtQuality::Normal)
+		tryEndpoints(minInner, maxInner);
+
+	if (quality >= DxtQuality::High) {
+		// Pulling the extremes in trades a little error on the outliers for finer steps in between.
+		static constexpr auto SearchRange = 4;
+		for (auto d0 = 0; d0 < SearchRange; ++d0) {
+			for (auto d1 = 0; d1 < SearchRange; ++d1) {
+				if (maxAlpha - d0 > minAlpha + d1)
+					tryEndpoints(maxAlpha - d0, minAlpha + d1);
+				if (minInner + d0 <= maxInner - d1)
+					tryEndpoints(minInner + d0, maxInner - d1);
+			}
+		}
+	}
+
+	out[0] = best0;
+	out[1] = best1;
+	for (size_t i = 0; i < 6; ++i)
+		out[2 + i] = static_cast<uint8_t>(bestIndices >> (8 * i));
+}
+
+void Sqex::Texture::EncodeDxtBlock(Format type, const RGBA8888* pixels, uint8_t* block, DxtQuality quality) {
+	switch (type) {
+		case Format::DXT1:
+			EncodeColorBlock(pixels, block, quality, true);
+			break;
+
+		case Format::DXT3:
+			EncodeExplicitAlphaBlock(pixels, block);
+			EncodeColorBlock(pixels, block + 8, quality, false);
+			break;
+
+		case Format::DXT5:
+			EncodeInterpolatedAlphaBlock(pixels, block, quality);
+			EncodeColorBlock(pixels, block + 8, quality, false);
+			break;
+
+		default:
+			throw std::invalid_argument("Unsupported type");
+	}
+}
+
+std::vector<uint8_t> Sqex::Texture::EncodeDxt(Format type, size_t width, size_t height, size_t depth, std::span<const RGBA8888> pixels, DxtQuality quality) {
+	if (type != Format::DXT1 && type != Format::DXT3 && type != Format::DXT5)
+		throw std::invalid_argument("Unsupported type");
+	if (pixels.size() < width * height * depth)
+		throw std::invalid_argument("pixels is smaller than width * height * depth");
+	if (!width || !height || !depth)
+		return {};
+
+	const auto cbBlock = RawDataLength(type, 1, 1, 1);
+	const auto blockCountX = (width + 3) / 4;
+	const auto blockCountY = (height + 3) / 4;
+	std::vector<uint8_t> result(RawDataLength(type, width, height, depth));
+
+	Utils::Win32::ParallelFor(blockCountY * depth, [&](size_t rowIndex) {
+		const auto layer = rowIndex / blockCountY;
+		const auto y0 = rowIndex % blockCountY * 4;
+		const auto source = pixels.subspan(layer * width * height, width * height);
+		auto target = &result[rowIndex * blockCountX * cbBlock];
+
+		RGBA8888 blockPixels[16];
+		for (size_t bx = 0; bx < blockCountX; ++bx, target += cbBlock) {
+			for (size_t dy = 0; dy < 4; ++dy) {
+				const auto y = std::min(y0 + dy, height - 1);
+				for (size_t dx = 0; dx < 4; ++dx)
+					blockPixels[dy * 4 + dx] = source[y * width + std::min(bx * 4 + dx, width - 1)];
+			}
+			EncodeDxtBlock(type, blockPixels, target, quality);
+		}
+	});
+	return result;
+}
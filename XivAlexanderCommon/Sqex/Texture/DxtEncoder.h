@@ -0,0 +1,25 @@
+#pragma once
+
+#include "XivAlexanderCommon/Sqex/Texture.h"
+
+namespace Sqex::Texture {
+	enum class DxtQuality {
+		// Colors are fit by the extremes of their projection onto the block's principal axis.
+		Fast,
+
+		// Fast, followed by least squares refinement of the endpoints against the chosen indices.
+		Normal,
+
+		// Tries every ordered split of the colors along the principal axis into as many clusters as the palette has entries.
+		// DXT1 also tries the three color palette on opaque blocks, and DXT5 searches around the alpha extremes.
+		High,
+	};
+
+	// Encodes 16 pixels of a 4x4 block, in row-major order and in the byte order of A8R8G8B8, into 8 bytes for DXT1 or 16 bytes for DXT3 and DXT5.
+	// DXT1 blocks use the three color palette with transparent black whenever a pixel has opacity below 128.
+	void EncodeDxtBlock(Format type, const RGBA8888* pixels, uint8_t* block, DxtQuality quality = DxtQuality::Normal);
+
+	// Encodes width * height * depth pixels into RawDataLength(type, width, height, depth) bytes, compressing rows of blocks in parallel.
+	// Blocks that extend past the image repeat its edge pixels.
+	std::vector<uint8_t> EncodeDxt(Format type, size_t width, size_t height, size_t depth, std::span<const RGBA8888> pixels, DxtQuality quality = DxtQuality::Normal);
+}
@@ -1,7 +1,8 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Sqex/Texture/Mipmap.h"
 
-#include "XivAlexanderCommon/Utils/Dxt.h"
+#include "XivAlexanderCommon/Sqex/Texture/DxtDecoder.h"
+#include "XivAlexanderCommon/Sqex/Texture/PixelConverter.h"
 
 Sqex::Texture::MipmapStream::MipmapStream(size_t width, size_t height, size_t layers, Format type)
 	: Width(static_cast<uint16_t>(width))
@@ -393,7 +394,8 @@ std::shared_ptr<Sqex::Texture::MemoryBackedMipmap> Sqex::Texture::MemoryBackedMi
 
 	const auto width = stream->Width;
 	const auto height = stream->Height;
-	const auto pixelCount = static_cast<size_t>(width) * height;
+	const auto depth = stream->Depth;
+	const auto pixelCount = static_cast<size_t>(width) * height * depth;
 	const auto cbSource = static_cast<size_t>(stream->StreamSize());
 
 	std::vector<uint8_t> result(pixelCount * sizeof RGBA8888);
@@ -403,44 +405,25 @@ std::shared_ptr<Sqex::Texture::MemoryBackedMipmap> Sqex::Texture::MemoryBackedMi
 	switch (stream->Type) {
 		case Format::L8:
 		case Format::A8:
-		{
-			if (cbSource < pixelCount)
-				throw std::runtime_error("Truncated data detected");
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0; i < len; ++pos, ++i) {
-					rgba8888view[pos].Value = buf8[i] * 0x10101UL | 0xFF000000UL;
-					// result[pos].R = result[pos].G = result[pos].B = result[pos].A = buf8[i];
-				}
-			}
-			break;
-		}
-
 		case Format::A4R4G4B4:
-		{
-			if (cbSource < pixelCount * sizeof RGBA4444)
-				throw std::runtime_error("Truncated data detected");
-			const auto view = span_cast<RGBA4444>(buf8);
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len / sizeof RGBA4444; i < count; ++pos, ++i)
-					rgba8888view[pos].SetFrom(view[i].R * 17, view[i].G * 17, view[i].B * 17, view[i].A * 17);
-			}
-			break;
-		}
-
 		case Format::A1R5G5B5:
+		case Format::R32F:
+		case Format::G16R16F:
+		case Format::G32R32F:
+		case Format::A16B16G16R16F:
+		case Format::A32B32G32R32F:
+		case Format::D16:
 		{
-			if (cbSource < pixelCount * sizeof RGBA5551)
+			const auto bpp = BytesPerPixel(stream->Type);
+			if (cbSource < pixelCount * bpp)
 				throw std::runtime_error("Truncated data detected");
-			const auto view = span_cast<RGBA5551>(buf8);
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len / sizeof RGBA5551; i < count; ++pos, ++i)
-					rgba8888view[pos].SetFrom(view[i].R * 255 / 31, view[i].G * 255 / 31, view[i].B * 255 / 31, view[i].A * 255);
+			const auto pixelsPerChunk = sizeof buf8 / bpp;
+			while (pos < pixelCount) {
+				const auto count = std::min(pixelCount - pos, pixelsPerChunk);
+				stream->ReadStream(read, buf8, count * bpp);
+				read += static_cast<uint32_t>(count * bpp);
+				ConvertToRGBA8888(stream->Type, std::span(buf8, count * bpp), rgba8888view.subspan(pos, count));
+				pos += static_cast<uint32_t>(count);
 			}
 			break;
 		}
@@ -452,90 +435,17 @@ std::shared_ptr<Sqex::Texture::MemoryBackedMipmap> Sqex::Texture::MemoryBackedMi
 			stream->ReadStream(0, std::span(rgba8888view));
 			break;
 
-		case Format::A16B16G16R16F:
-		{
-			if (cbSource < pixelCount * sizeof RGBAHHHH)
-				throw std::runtime_error("Truncated data detected");
-			stream->ReadStream(0, std::span(rgba8888view));
-			const auto view = span_cast<RGBAHHHH>(buf8);
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len / sizeof RGBAHHHH; i < count; ++pos, ++i)
-					rgba8888view[pos].SetFromF(view[i]);
-			}
-			break;
-		}
-
-		case Format::A32B32G32R32F:
-		{
-			if (cbSource < pixelCount * sizeof RGBAFFFF)
-				throw std::runtime_error("Truncated data detected");
-			stream->ReadStream(0, std::span(rgba8888view));
-			const auto view = span_cast<RGBAFFFF>(buf8);
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len / sizeof RGBAFFFF; i < count; ++pos, ++i)
-					rgba8888view[pos].SetFromF(view[i]);
-			}
-			break;
-		}
-
 		case Format::DXT1:
-		{
-			if (cbSource < pixelCount * 8)
-				throw std::runtime_error("Truncated data detected");
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len; i < count; i += 8, pos += 8) {
-					DecompressBlockDXT1(
-						pos / 2 % width,
-						pos / 2 / width * 4,
-						width, &buf8[i], reinterpret_cast<uint32_t*>(&rgba8888view[0]));
-				}
-			}
-			break;
-		}
-
 		case Format::DXT3:
-		{
-			if (cbSource < pixelCount * 16)
-				throw std::runtime_error("Truncated data detected");
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len; i < count; i += 16, pos += 16) {
-					DecompressBlockDXT1(
-						pos / 4 % width,
-						pos / 4 / width * 4,
-						width, &buf8[i], reinterpret_cast<uint32_t*>(&rgba8888view[0]));
-					for (size_t dy = 0; dy < 4; dy += 1) {
-						for (size_t dx = 0; dx < 4; dx += 2) {
-							rgba8888view[dy * width + dx].A = 17 * (buf8[i + dy * 2 + dx / 2] & 0xF);
-							rgba8888view[dy * width + dx + 1].A = 17 * (buf8[i + dy * 2 + dx / 2] >> 4);
-						}
-					}
-				}
-			}
-			break;
-		}
-
 		case Format::DXT5:
+		case Format::BC4:
+		case Format::BC5:
+		case Format::BC7:
 		{
-			if (cbSource < pixelCount * 16)
+			const auto cbBlocks = RawDataLength(stream->Type, width, height, depth);
+			if (cbSource < cbBlocks)
 				throw std::runtime_error("Truncated data detected");
-			while (const auto len = static_cast<uint32_t>(std::min<uint64_t>(cbSource - read, sizeof buf8))) {
-				stream->ReadStream(read, buf8, len);
-				read += len;
-				for (size_t i = 0, count = len; i < count; i += 16, pos += 16) {
-					DecompressBlockDXT5(
-						pos / 4 % width,
-						pos / 4 / width * 4,
-						width, &buf8[i], reinterpret_cast<uint32_t*>(&rgba8888view[0]));
-				}
-			}
+			DecodeDxt(stream->Type, width, height, depth, stream->ReadStreamIntoVector<uint8_t>(0, cbBlocks), rgba8888view);
 			break;
 		}
 
@@ -547,6 +457,31 @@ std::shared_ptr<Sqex::Texture::MemoryBackedMipmap> Sqex::Texture::MemoryBackedMi
 	return std::make_shared<MemoryBackedMipmap>(stream->Width, stream->Height, stream->Depth, type, std::move(result));
 }
 
+std::shared_ptr<Sqex::Texture::MemoryBackedMipmap> Sqex::Texture::MemoryBackedMipmap::NewFrom(const MipmapStream* stream, Format type, DxtQuality quality) {
+	if (type == Format::A8R8G8B8 || type == Format::X8R8G8B8)
+		return NewARGB8888From(stream, type);
+
+	const auto width = stream->Width;
+	const auto height = stream->Height;
+	const auto depth = stream->Depth;
+	const auto pixels = stream->ViewARGB8888()->ReadStreamIntoVector<RGBA8888>(0, static_cast<size_t>(width) * height * depth);
+
+	std::vector<uint8_t> result;
+	switch (type) {
+		case Format::DXT1:
+		case Format::DXT3:
+		case Format::DXT5:
+			result = EncodeDxt(type, width, height, depth, pixels, quality);
+			break;
+
+		default:
+			result.resize(RawDataLength(type, width, height, depth));
+			ConvertFromRGBA8888(type, pixels, result);
+	}
+
+	return std::make_shared<MemoryBackedMipmap>(width, height, depth, type, std::move(result));
+}
+
 uint64_t Sqex::Texture::MemoryBackedMipmap::ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const {
 	const auto available = static_cast<size_t>(std::min(m_data.size() - offset, length));
 	std::copy_n(&m_data[static_cast<size_t>(offset)], available, static_cast<char*>(buf));
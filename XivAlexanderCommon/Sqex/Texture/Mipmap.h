@@ -1,6 +1,7 @@
 #pragma once
 
 #include "XivAlexanderCommon/Sqex/Texture.h"
+#include "XivAlexanderCommon/Sqex/Texture/DxtEncoder.h"
 
 namespace Sqex::Texture {
 	class MipmapStream : public RandomAccessStream {
@@ -55,6 +56,9 @@ namespace Sqex::Texture {
 
 		static std::shared_ptr<MemoryBackedMipmap> NewARGB8888From(const MipmapStream* stream, Format type = Format::A8R8G8B8);
 
+		// Converts stream into any supported format; DXT formats get compressed at the given quality.
+		static std::shared_ptr<MemoryBackedMipmap> NewFrom(const MipmapStream* stream, Format type, DxtQuality quality = DxtQuality::Normal);
+
 		[[nodiscard]] uint64_t StreamSize() const override { return static_cast<uint32_t>(m_data.size());  }
 		uint64_t ReadStreamPartial(uint64_t offset, void* buf, uint64_t length) const override;
 
@@ -0,0 +1,223 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Texture/MipmapGenerator.h"
+
+#include <emmintrin.h>
+#include <numbers>
+
+#include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
+
+// Size of the per band scratch buffers to aim for; roughly the size of a L2 cache.
+static constexpr size_t BandScratchBudget = 256 * 1024;
+
+// Half width of the Kaiser filter, in target pixels, and the shape parameter of its window.
+static constexpr double KaiserHalfWidth = 1.5;
+static constexpr double KaiserAlpha = 4.;
+
+namespace {
+	// Weights of a run of consecutive source pixels that make up one target pixel.
+	struct FilterKernel {
+		size_t First;
+		std::vector<float> Weights;
+
+		[[nodiscard]] size_t Last() const {
+			return First + Weights.size() - 1;
+		}
+	};
+}
+
+static double BesselI0(double x) {
+	double sum = 1, term = 1;
+	for (int k = 1; term > sum * 1e-12; ++k) {
+		const auto t = x / (2. * k);
+		term *= t * t;
+		sum += term;
+	}
+	return sum;
+}
+
+static double Kaiser(double x) {
+	if (std::abs(x) >= KaiserHalfWidth)
+		return 0;
+
+	const auto sinc = x == 0 ? 1. : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+	const auto r = x / KaiserHalfWidth;
+	return sinc * BesselI0(KaiserAlpha * std::sqrt(1 - r * r)) / BesselI0(KaiserAlpha);
+}
+
+static std::vector<FilterKernel> MakeKernels(size_t sourceLength, size_t targetLength, Sqex::Texture::MipmapFilter filter) {
+	const auto scale = static_cast<double>(sourceLength) / static_cast<double>(targetLength);
+
+	std::vector<FilterKernel> kernels(targetLength);
+	std::vector<double> weights(sourceLength);
+	for (size_t i = 0; i < targetLength; ++i) {
+		std::ranges::fill(weights, 0.);
+
+		switch (filter) {
+			case Sqex::Texture::MipmapFilter::Box:
+			{
+				const auto from = scale * static_cast<double>(i);
+				const auto to = scale * static_cast<double>(i + 1);
+				for (auto j = static_cast<size_t>(from); j < sourceLength && static_cast<double>(j) < to; ++j)
+					weights[j] = std::min<double>(to, static_cast<double>(j + 1)) - std::max<double>(from, static_cast<double>(j));
+				break;
+			}
+
+			case Sqex::Texture::MipmapFilter::Kaiser:
+			{
+				// Pixels past the edges take the weight of the pixel at the edge.
+				const auto center = scale * (static_cast<double>(i) + 0.5);
+				const auto from = static_cast<ptrdiff_t>(std::floor(center - KaiserHalfWidth * scale));
+				const auto to = static_cast<ptrdiff_t>(std::ceil(center + KaiserHalfWidth * scale));
+				for (auto j = from; j <= to; ++j) {
+					const auto clamped = static_cast<size_t>(std::clamp<ptrdiff_t>(j, 0, static_cast<ptrdiff_t>(sourceLength) - 1));
+					weights[clamped] += Kaiser((static_cast<double>(j) + 0.5 - center) / scale);
+				}
+				break;
+			}
+
+			default:
+				throw std::invalid_argument("Unsupported filter");
+		}
+
+		const auto first = static_cast<size_t>(std::ranges::find_if(weights, [](double w) { return w != 0; }) - weights.begin());
+		const auto last = sourceLength - 1 - static_cast<size_t>(std::find_if(weights.rbegin(), weights.rend(), [](double w) { return w != 0; }) - weights.rbegin());
+		if (first > last)
+			throw std::runtime_error("filter has no weight");
+
+		const auto sum = std::accumulate(weights.begin() + first, weights.begin() + last + 1, 0.);
+		auto& kernel = kernels[i];
+		kernel.First = first;
+		kernel.Weights.reserve(last - first + 1);
+		for (auto j = first; j <= last; ++j)
+			kernel.Weights.push_back(static_cast<float>(weights[j] / sum));
+	}
+	return kernels;
+}
+
+static float SrgbToLinear(float v) {
+	return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+static float LinearToSrgb(float v) {
+	return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1 / 2.4f) - 0.055f;
+}
+
+static const std::array<float, 256>& ByteToFloatTable(bool srgb) {
+	static const auto tables = [] {
+		std::array<std::array<float, 256>, 2> res{};
+		for (size_t i = 0; i < 256; ++i) {
+			res[0][i] = static_cast<float>(i) / 255.f;
+			res[1][i] = SrgbToLinear(static_cast<float>(i) / 255.f);
+		}
+		return res;
+	}();
+	return tables[srgb ? 1 : 0];
+}
+
+// Indexed by linear values scaled to [0, 65535]; fine enough to round the darkest sRGB steps correctly.
+static const std::vector<uint8_t>& LinearToSrgbByteTable() {
+	static const auto table = [] {
+		std::vector<uint8_t> res(65536);
+		for (size_t i = 0; i < res.size(); ++i)
+			res[i] = static_cast<uint8_t>(std::lround(LinearToSrgb(static_cast<float>(i) / 65535.f) * 255.f));
+		return res;
+	}();
+	return table;
+}
+
+Sqex::Texture::MipmapGenerator::MipmapGenerator(std::shared_ptr<const MipmapStream> base, MipmapFilter filter, bool srgb)
+	: m_source(base->ViewARGB8888())
+	, m_filter(filter)
+	, m_srgb(srgb) {
+	// Every layer of the base has to be there; Next reads them all.
+	if (m_source->StreamSize() < static_cast<uint64_t>(m_source->Width) * m_source->Height * m_source->Depth * sizeof RGBA8888)
+		throw std::invalid_argument("base mipmap does not hold every layer");
+}
+
+bool Sqex::Texture::MipmapGenerator::HasNext() const {
+	return m_source->Width > 1 || m_source->Height > 1 || m_source->Depth > 1;
+}
+
+std::shared_ptr<Sqex::Texture::MemoryBackedMipmap> Sqex::Texture::MipmapGenerator::Next() {
+	const size_t sw = m_source->Width, sh = m_source->Height, sd = m_source->Depth;
+	const auto dw = std::max<size_t>(1, sw / 2), dh = std::max<size_t>(1, sh / 2), dd = std::max<size_t>(1, sd / 2);
+
+	const auto kernelsX = MakeKernels(sw, dw, m_filter);
+	const auto kernelsY = MakeKernels(sh, dh, m_filter);
+	const auto kernelsZ = MakeKernels(sd, dd, m_filter);
+
+	// Each band keeps every source row it needs filtered horizontally, so scale the band down by how many source rows go into a target row.
+	const auto bytesPerTargetRow = dw * sizeof __m128 * (sh / dh + 1);
+	const auto bandHeight = std::max<size_t>(4, BandScratchBudget / bytesPerTargetRow / 4 * 4);
+	const auto bandCount = (dh + bandHeight - 1) / bandHeight;
+
+	const auto& toFloat = ByteToFloatTable(m_srgb);
+	const auto& toSrgb = LinearToSrgbByteTable();
+
+	std::vector<uint8_t> result(dw * dh * dd * sizeof RGBA8888);
+	Utils::Win32::ParallelFor(dd * bandCount, [&](size_t taskIndex) {
+		const auto z = taskIndex / bandCount;
+		const auto y0 = taskIndex % bandCount * bandHeight;
+		const auto y1 = std::min(dh, y0 + bandHeight);
+		const auto r0 = kernelsY[y0].First;
+		const auto r1 = kernelsY[y1 - 1].Last();
+
+		std::vector<RGBA8888> sourceRow(sw);
+		std::vector<__m128> sourceRowFloat(sw);
+		std::vector<__m128> filteredRows((r1 - r0 + 1) * dw);
+		std::vector<__m128> band((y1 - y0) * dw, _mm_setzero_ps());
+
+		const auto& kernelZ = kernelsZ[z];
+		for (size_t k = 0; k < kernelZ.Weights.size(); ++k) {
+			const auto sz = kernelZ.First + k;
+			const auto wz = _mm_set1_ps(kernelZ.Weights[k]);
+
+			for (auto r = r0; r <= r1; ++r) {
+				m_source->ReadStream((sz * sh + r) * sw * sizeof RGBA8888, std::span(sourceRow));
+				for (size_t x = 0; x < sw; ++x) {
+					const auto v = sourceRow[x].Value;
+					sourceRowFloat[x] = _mm_setr_ps(toFloat[v & 0xFF], toFloat[(v >> 8) & 0xFF], toFloat[(v >> 16) & 0xFF], static_cast<float>(v >> 24) / 255.f);
+				}
+
+				const auto out = &filteredRows[(r - r0) * dw];
+				for (size_t x = 0; x < dw; ++x) {
+					const auto& kernel = kernelsX[x];
+					auto acc = _mm_setzero_ps();
+					for (size_t i = 0; i < kernel.Weights.size(); ++i)
+						acc = _mm_add_ps(acc, _mm_mul_ps(sourceRowFloat[kernel.First + i], _mm_set1_ps(kernel.Weights[i])));
+					out[x] = acc;
+				}
+			}
+
+			for (auto y = y0; y < y1; ++y) {
+				const auto& kernel = kernelsY[y];
+				const auto out = &band[(y - y0) * dw];
+				for (size_t i = 0; i < kernel.Weights.size(); ++i) {
+					const auto in = &filteredRows[(kernel.First + i - r0) * dw];
+					const auto w = _mm_mul_ps(wz, _mm_set1_ps(kernel.Weights[i]));
+					for (size_t x = 0; x < dw; ++x)
+						out[x] = _mm_add_ps(out[x], _mm_mul_ps(in[x], w));
+				}
+			}
+		}
+
+		const auto zero = _mm_setzero_ps();
+		const auto one = _mm_set1_ps(1.f);
+		const auto scale = m_srgb ? _mm_setr_ps(65535.f, 65535.f, 65535.f, 255.f) : _mm_set1_ps(255.f);
+		const auto target = span_cast<RGBA8888>(result).subspan((z * dh + y0) * dw, (y1 - y0) * dw);
+		for (size_t i = 0; i < target.size(); ++i) {
+			alignas(16) int32_t c[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(c), _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(band[i], zero), one), scale)));
+			if (m_srgb) {
+				c[0] = toSrgb[c[0]];
+				c[1] = toSrgb[c[1]];
+				c[2] = toSrgb[c[2]];
+			}
+			target[i].Value = static_cast<uint32_t>(c[0] | (c[1] << 8) | (c[2] << 16) | (c[3] << 24));
+		}
+	});
+
+	auto res = std::make_shared<MemoryBackedMipmap>(dw, dh, dd, m_source->Type, std::move(result));
+	m_source = res;
+	return res;
+}
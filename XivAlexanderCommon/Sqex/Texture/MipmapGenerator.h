@@ -0,0 +1,32 @@
+#pragma once
+
+#include "XivAlexanderCommon/Sqex/Texture/Mipmap.h"
+
+namespace Sqex::Texture {
+	enum class MipmapFilter {
+		// Averages the source pixels covered by each target pixel.
+		Box,
+
+		// Kaiser windowed sinc spanning three target pixels; sharper than Box, at the cost of slight ringing.
+		Kaiser,
+	};
+
+	// Generates a mipmap chain one level at a time, each from the level before it.
+	// Levels are filtered in bands of rows sized to fit in cache, which are processed in parallel.
+	// Only the last generated level is kept around, so a chain never takes much more memory than its first two levels in A8R8G8B8.
+	class MipmapGenerator {
+		std::shared_ptr<const MipmapStream> m_source;
+		const MipmapFilter m_filter;
+		const bool m_srgb;
+
+	public:
+		// If srgb is set, color channels are filtered after being converted to linear space; opacity is always filtered as is.
+		MipmapGenerator(std::shared_ptr<const MipmapStream> base, MipmapFilter filter = MipmapFilter::Box, bool srgb = false);
+
+		// Whether the last generated level, or the base if none has been generated yet, is larger than 1x1x1.
+		[[nodiscard]] bool HasNext() const;
+
+		// Generates the next level in A8R8G8B8, halving each dimension down to at least 1.
+		std::shared_ptr<MemoryBackedMipmap> Next();
+	};
+}
@@ -63,6 +63,31 @@ void Sqex::Texture::ModifiableTextureStream::SetMipmap(size_t mipmapIndex, size_
 	mipmaps.at(mipmapIndex) = std::move(mipmap);
 }
 
+void Sqex::Texture::ModifiableTextureStream::SetMipmapConverted(size_t mipmapIndex, size_t repeatIndex, std::shared_ptr<MipmapStream> mipmap, DxtQuality quality) {
+	if (mipmap->Type == m_header.Type)
+		SetMipmap(mipmapIndex, repeatIndex, std::move(mipmap));
+	else
+		SetMipmap(mipmapIndex, repeatIndex, MemoryBackedMipmap::NewFrom(mipmap.get(), m_header.Type, quality));
+}
+
+void Sqex::Texture::ModifiableTextureStream::GenerateMipmaps(size_t mipmapCount, MipmapFilter filter, bool srgb, DxtQuality quality) {
+	if (mipmapCount == SIZE_MAX) {
+		mipmapCount = 1;
+		for (auto size = std::max<uint16_t>({ m_header.Width, m_header.Height, m_header.Depth }); size > 1; size >>= 1)
+			++mipmapCount;
+	}
+
+	Resize(mipmapCount, m_repeats.size());
+	for (size_t repeatI = 0; repeatI < m_repeats.size(); ++repeatI) {
+		if (!m_repeats[repeatI][0])
+			throw std::runtime_error("first mipmap is not set");
+
+		auto generator = MipmapGenerator(m_repeats[repeatI][0], filter, srgb);
+		for (size_t mipmapI = 1; mipmapI < mipmapCount; ++mipmapI)
+			SetMipmapConverted(mipmapI, repeatI, generator.Next(), quality);
+	}
+}
+
 void Sqex::Texture::ModifiableTextureStream::Resize(size_t mipmapCount, size_t repeatCount) {
 	if (mipmapCount == 0)
 		throw std::invalid_argument("mipmap count must be a positive integer");
@@ -2,6 +2,7 @@
 #include "XivAlexanderCommon/Sqex.h"
 #include "XivAlexanderCommon/Sqex/Texture.h"
 #include "XivAlexanderCommon/Sqex/Texture/Mipmap.h"
+#include "XivAlexanderCommon/Sqex/Texture/MipmapGenerator.h"
 
 namespace Sqex::Texture {
 	class ModifiableTextureStream : public RandomAccessStream {
@@ -17,6 +18,10 @@ namespace Sqex::Texture {
 
 		[[nodiscard]] std::shared_ptr<MipmapStream> GetMipmap(size_t mipmapIndex, size_t repeatIndex) const;
 		void SetMipmap(size_t mipmapIndex, size_t repeatIndex, std::shared_ptr<MipmapStream> mipmap);
+		// Converts mipmap into the format of this texture, compressing it if the format is DXT, and sets it.
+		void SetMipmapConverted(size_t mipmapIndex, size_t repeatIndex, std::shared_ptr<MipmapStream> mipmap, DxtQuality quality = DxtQuality::Normal);
+		// Resizes to mipmapCount mipmaps, or to the full chain down to 1x1x1 if SIZE_MAX, and regenerates every mipmap after the first of each repeat from the first.
+		void GenerateMipmaps(size_t mipmapCount = SIZE_MAX, MipmapFilter filter = MipmapFilter::Box, bool srgb = false, DxtQuality quality = DxtQuality::Normal);
 		void Resize(size_t mipmapCount, size_t repeatCount);
 
 		[[nodiscard]] uint64_t StreamSize() const override;
@@ -0,0 +1,379 @@
+#include "pch.h"
+#include "XivAlexanderCommon/Sqex/Texture/PixelConverter.h"
+
+#include <emmintrin.h>
+
+// Each converter runs an SSE2 main loop over as many whole vectors as it can, and finishes the rest with the
+// scalar per-pixel code, which also serves as the reference the vector code must match bit for bit.
+
+namespace {
+	using ToRGBA8888Function = void(*)(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count);
+	using FromRGBA8888Function = void(*)(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count);
+
+	struct FormatInfo {
+		Sqex::Texture::Format Type;
+		size_t BytesPerPixel;
+		ToRGBA8888Function ToRGBA8888;
+		FromRGBA8888Function FromRGBA8888;
+	};
+}
+
+static uint8_t UnitFloatToByte(float v) {
+	// Same as Clamp(255.f * v, 0.f, 255.f), which also sends NaN to 0.
+	return static_cast<uint8_t>(std::min(255.f, std::max(0.f, 255.f * v)));
+}
+
+static __m128i UnitFloatToInt32(__m128 v) {
+	// maxps returns its second operand if either is NaN, so NaN becomes 0 here as well.
+	v = _mm_max_ps(_mm_mul_ps(v, _mm_set1_ps(255.f)), _mm_setzero_ps());
+	return _mm_cvttps_epi32(_mm_min_ps(v, _mm_set1_ps(255.f)));
+}
+
+static __m128 HalfToFloatVector(__m128i halvesInInt32) {
+	// Shifting the exponent and mantissa into place and multiplying by 2^(127 - 15) rebiases normals and
+	// renormalizes subnormals exactly; infinities and NaNs only need their exponent widened.
+	const auto sign = _mm_slli_epi32(_mm_and_si128(halvesInInt32, _mm_set1_epi32(0x8000)), 16);
+	const auto magnitude = _mm_slli_epi32(_mm_and_si128(halvesInInt32, _mm_set1_epi32(0x7FFF)), 13);
+	auto result = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(_mm_set1_epi32(0x77800000))));
+	const auto isInfOrNan = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(0x0F7FFFFF));
+	result = _mm_or_si128(result, _mm_and_si128(isInfOrNan, _mm_set1_epi32(0x7F800000)));
+	return _mm_castsi128_ps(_mm_or_si128(result, sign));
+}
+
+// Rounds 16-bit lanes of value * multiplier / 255 to nearest, for value * multiplier + 128 < 65536.
+static __m128i MulDiv255(__m128i value, __m128i multiplier) {
+	const auto t = _mm_add_epi16(_mm_mullo_epi16(value, multiplier), _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Splits 8 pixels into one 16-bit lane per pixel for each channel.
+static void LoadPlanes(const Sqex::Texture::RGBA8888* src, __m128i& r, __m128i& g, __m128i& b, __m128i& a) {
+	const auto p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+	const auto p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+	const auto mask = _mm_set1_epi32(0xFF);
+	r = _mm_packs_epi32(_mm_and_si128(p0, mask), _mm_and_si128(p1, mask));
+	g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), mask), _mm_and_si128(_mm_srli_epi32(p1, 8), mask));
+	b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), mask), _mm_and_si128(_mm_srli_epi32(p1, 16), mask));
+	a = _mm_packs_epi32(_mm_srli_epi32(p0, 24), _mm_srli_epi32(p1, 24));
+}
+
+static void L8ToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto opaque = _mm_set1_epi32(0xFF000000);
+	for (; i + 16 <= count; i += 16) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const auto lo = _mm_unpacklo_epi8(v, v);
+		const auto hi = _mm_unpackhi_epi8(v, v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_unpacklo_epi16(lo, lo), opaque));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_or_si128(_mm_unpackhi_epi16(lo, lo), opaque));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_or_si128(_mm_unpacklo_epi16(hi, hi), opaque));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_or_si128(_mm_unpackhi_epi16(hi, hi), opaque));
+	}
+	for (; i < count; ++i)
+		dst[i].Value = src[i] * 0x10101UL | 0xFF000000UL;
+}
+
+static void L8FromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m128i r0, r1, unused;
+		LoadPlanes(src + i, r0, unused, unused, unused);
+		LoadPlanes(src + i + 8, r1, unused, unused, unused);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(r0, r1));
+	}
+	for (; i < count; ++i)
+		dst[i] = static_cast<uint8_t>(src[i].R);
+}
+
+static void RGBA4444ToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto nibble = _mm_set1_epi8(0x0F);
+	for (; i + 8 <= count; i += 8) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+		const auto lo = _mm_and_si128(v, nibble);
+		const auto hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+		// every byte is below 16, so shifting 16-bit lanes never carries across bytes; c | c << 4 == c * 17.
+		const auto p0 = _mm_unpacklo_epi8(lo, hi);
+		const auto p1 = _mm_unpackhi_epi8(lo, hi);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(p0, _mm_slli_epi16(p0, 4)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_or_si128(p1, _mm_slli_epi16(p1, 4)));
+	}
+	const auto view = reinterpret_cast<const Sqex::Texture::RGBA4444*>(src);
+	for (; i < count; ++i)
+		dst[i].SetFrom(view[i].R * 17, view[i].G * 17, view[i].B * 17, view[i].A * 17);
+}
+
+static void RGBA4444FromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	size_t i = 0;
+	const auto fifteen = _mm_set1_epi16(15);
+	for (; i + 8 <= count; i += 8) {
+		__m128i r, g, b, a;
+		LoadPlanes(src + i, r, g, b, a);
+		auto v = MulDiv255(r, fifteen);
+		v = _mm_or_si128(v, _mm_slli_epi16(MulDiv255(g, fifteen), 4));
+		v = _mm_or_si128(v, _mm_slli_epi16(MulDiv255(b, fifteen), 8));
+		v = _mm_or_si128(v, _mm_slli_epi16(MulDiv255(a, fifteen), 12));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), v);
+	}
+	const auto view = reinterpret_cast<Sqex::Texture::RGBA4444*>(dst);
+	for (; i < count; ++i)
+		view[i].SetFrom((src[i].R * 15 + 127) / 255, (src[i].G * 15 + 127) / 255, (src[i].B * 15 + 127) / 255, (src[i].A * 15 + 127) / 255);
+}
+
+static void RGBA5551ToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto mask5 = _mm_set1_epi16(0x1F);
+	const auto scale = _mm_set1_epi16(255);
+	// floor(c * 255 / 31) == ((c * 255) * 8457 >> 16) >> 2 for every 5-bit c.
+	const auto reciprocal = _mm_set1_epi16(8457);
+	for (; i + 8 <= count; i += 8) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+		const auto r = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(v, mask5), scale), reciprocal), 2);
+		const auto g = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(v, 5), mask5), scale), reciprocal), 2);
+		const auto b = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(v, 10), mask5), scale), reciprocal), 2);
+		const auto a = _mm_and_si128(_mm_srai_epi16(v, 15), _mm_set1_epi16(0xFF));
+		const auto rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+		const auto ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(rg, ba));
+	}
+	const auto view = reinterpret_cast<const Sqex::Texture::RGBA5551*>(src);
+	for (; i < count; ++i)
+		dst[i].SetFrom(view[i].R * 255 / 31, view[i].G * 255 / 31, view[i].B * 255 / 31, view[i].A * 255);
+}
+
+static void RGBA5551FromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	size_t i = 0;
+	const auto thirtyOne = _mm_set1_epi16(31);
+	for (; i + 8 <= count; i += 8) {
+		__m128i r, g, b, a;
+		LoadPlanes(src + i, r, g, b, a);
+		auto v = MulDiv255(r, thirtyOne);
+		v = _mm_or_si128(v, _mm_slli_epi16(MulDiv255(g, thirtyOne), 5));
+		v = _mm_or_si128(v, _mm_slli_epi16(MulDiv255(b, thirtyOne), 10));
+		v = _mm_or_si128(v, _mm_slli_epi16(_mm_srli_epi16(a, 7), 15));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), v);
+	}
+	const auto view = reinterpret_cast<Sqex::Texture::RGBA5551*>(dst);
+	for (; i < count; ++i)
+		view[i].SetFrom((src[i].R * 31 + 127) / 255, (src[i].G * 31 + 127) / 255, (src[i].B * 31 + 127) / 255, (src[i].A + 127) / 255);
+}
+
+static void RGBA8888ToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	std::copy_n(src, count * sizeof Sqex::Texture::RGBA8888, reinterpret_cast<uint8_t*>(dst));
+}
+
+static void RGBA8888FromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	std::copy_n(reinterpret_cast<const uint8_t*>(src), count * sizeof Sqex::Texture::RGBA8888, dst);
+}
+
+// Packs four pixels worth of 32-bit channel values, already within [0, 255], into RGBA8888.
+static void StoreRGBA(Sqex::Texture::RGBA8888* dst, __m128i p0, __m128i p1, __m128i p2, __m128i p3) {
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+}
+
+// Packs four pixels of (R, G) pairs, already within [0, 255], into RGBA8888 with B = 0 and A = 255.
+static void StoreRG(Sqex::Texture::RGBA8888* dst, __m128i rg01, __m128i rg23) {
+	const auto bytes = _mm_packus_epi16(_mm_packs_epi32(rg01, rg23), _mm_setzero_si128());
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bytes, _mm_set1_epi16(static_cast<short>(0xFF00))));
+}
+
+static void RGBAHHHHToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto zero = _mm_setzero_si128();
+	for (; i + 4 <= count; i += 4) {
+		const auto v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8));
+		const auto v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8 + 16));
+		StoreRGBA(dst + i,
+			UnitFloatToInt32(HalfToFloatVector(_mm_unpacklo_epi16(v0, zero))),
+			UnitFloatToInt32(HalfToFloatVector(_mm_unpackhi_epi16(v0, zero))),
+			UnitFloatToInt32(HalfToFloatVector(_mm_unpacklo_epi16(v1, zero))),
+			UnitFloatToInt32(HalfToFloatVector(_mm_unpackhi_epi16(v1, zero))));
+	}
+	const auto view = reinterpret_cast<const Sqex::Texture::RGBAHHHH*>(src);
+	for (; i < count; ++i)
+		dst[i].SetFrom(UnitFloatToByte(view[i].R), UnitFloatToByte(view[i].G), UnitFloatToByte(view[i].B), UnitFloatToByte(view[i].A));
+}
+
+static void RGBAFFFFToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto floats = reinterpret_cast<const float*>(src);
+	for (; i + 4 <= count; i += 4) {
+		StoreRGBA(dst + i,
+			UnitFloatToInt32(_mm_loadu_ps(floats + i * 4)),
+			UnitFloatToInt32(_mm_loadu_ps(floats + i * 4 + 4)),
+			UnitFloatToInt32(_mm_loadu_ps(floats + i * 4 + 8)),
+			UnitFloatToInt32(_mm_loadu_ps(floats + i * 4 + 12)));
+	}
+	const auto view = reinterpret_cast<const Sqex::Texture::RGBAFFFF*>(src);
+	for (; i < count; ++i)
+		dst[i].SetFrom(UnitFloatToByte(view[i].R), UnitFloatToByte(view[i].G), UnitFloatToByte(view[i].B), UnitFloatToByte(view[i].A));
+}
+
+static void R32FToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto floats = reinterpret_cast<const float*>(src);
+	const auto opaque = _mm_set1_epi32(0xFF000000);
+	for (; i + 4 <= count; i += 4)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(UnitFloatToInt32(_mm_loadu_ps(floats + i)), opaque));
+	for (; i < count; ++i)
+		dst[i].SetFrom(UnitFloatToByte(floats[i]), 0, 0, 255);
+}
+
+static void G32R32FToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto floats = reinterpret_cast<const float*>(src);
+	for (; i + 4 <= count; i += 4)
+		StoreRG(dst + i, UnitFloatToInt32(_mm_loadu_ps(floats + i * 2)), UnitFloatToInt32(_mm_loadu_ps(floats + i * 2 + 4)));
+	for (; i < count; ++i)
+		dst[i].SetFrom(UnitFloatToByte(floats[i * 2]), UnitFloatToByte(floats[i * 2 + 1]), 0, 255);
+}
+
+static void G16R16FToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	size_t i = 0;
+	const auto zero = _mm_setzero_si128();
+	for (; i + 4 <= count; i += 4) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+		StoreRG(dst + i,
+			UnitFloatToInt32(HalfToFloatVector(_mm_unpacklo_epi16(v, zero))),
+			UnitFloatToInt32(HalfToFloatVector(_mm_unpackhi_epi16(v, zero))));
+	}
+	const auto halves = reinterpret_cast<const uint16_t*>(src);
+	for (; i < count; ++i)
+		dst[i].SetFrom(UnitFloatToByte(Sqex::Texture::HalfToFloat(halves[i * 2])), UnitFloatToByte(Sqex::Texture::HalfToFloat(halves[i * 2 + 1])), 0, 255);
+}
+
+static void D16ToRGBA8888(const uint8_t* src, Sqex::Texture::RGBA8888* dst, size_t count) {
+	const auto depths = reinterpret_cast<const uint16_t*>(src);
+	for (size_t i = 0; i < count; ++i)
+		dst[i].Value = (depths[i] * 255UL + 32767UL) / 65535UL * 0x10101UL | 0xFF000000UL;
+}
+
+// There are only 256 possible channel values, so the half encoders look them up instead.
+// Decoding truncates, so entries whose nearest half would decode to one less get nudged up to the next half.
+static const std::array<uint16_t, 256>& ByteToHalfTable() {
+	static const auto table = []() {
+		std::array<uint16_t, 256> res{};
+		for (size_t i = 0; i < res.size(); ++i) {
+			res[i] = Sqex::Texture::FloatToHalf(static_cast<float>(i) / 255.f);
+			while (UnitFloatToByte(Sqex::Texture::HalfToFloat(res[i])) < i)
+				++res[i];
+		}
+		return res;
+	}();
+	return table;
+}
+
+static void RGBAHHHHFromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	const auto& table = ByteToHalfTable();
+	const auto halves = reinterpret_cast<uint16_t*>(dst);
+	for (size_t i = 0; i < count; ++i) {
+		halves[i * 4 + 0] = table[src[i].R];
+		halves[i * 4 + 1] = table[src[i].G];
+		halves[i * 4 + 2] = table[src[i].B];
+		halves[i * 4 + 3] = table[src[i].A];
+	}
+}
+
+static void G16R16FFromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	const auto& table = ByteToHalfTable();
+	const auto halves = reinterpret_cast<uint16_t*>(dst);
+	for (size_t i = 0; i < count; ++i) {
+		halves[i * 2 + 0] = table[src[i].R];
+		halves[i * 2 + 1] = table[src[i].G];
+	}
+}
+
+static void RGBAFFFFFromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	size_t i = 0;
+	const auto floats = reinterpret_cast<float*>(dst);
+	const auto zero = _mm_setzero_si128();
+	const auto scale = _mm_set1_ps(255.f);
+	for (; i + 4 <= count; i += 4) {
+		const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const auto lo = _mm_unpacklo_epi8(v, zero);
+		const auto hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_ps(floats + i * 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+		_mm_storeu_ps(floats + i * 4 + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+		_mm_storeu_ps(floats + i * 4 + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+		_mm_storeu_ps(floats + i * 4 + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+	}
+	for (; i < count; ++i) {
+		floats[i * 4 + 0] = static_cast<float>(src[i].R) / 255.f;
+		floats[i * 4 + 1] = static_cast<float>(src[i].G) / 255.f;
+		floats[i * 4 + 2] = static_cast<float>(src[i].B) / 255.f;
+		floats[i * 4 + 3] = static_cast<float>(src[i].A) / 255.f;
+	}
+}
+
+static void R32FFromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	const auto floats = reinterpret_cast<float*>(dst);
+	for (size_t i = 0; i < count; ++i)
+		floats[i] = static_cast<float>(src[i].R) / 255.f;
+}
+
+static void G32R32FFromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	const auto floats = reinterpret_cast<float*>(dst);
+	for (size_t i = 0; i < count; ++i) {
+		floats[i * 2 + 0] = static_cast<float>(src[i].R) / 255.f;
+		floats[i * 2 + 1] = static_cast<float>(src[i].G) / 255.f;
+	}
+}
+
+static void D16FromRGBA8888(const Sqex::Texture::RGBA8888* src, uint8_t* dst, size_t count) {
+	const auto depths = reinterpret_cast<uint16_t*>(dst);
+	for (size_t i = 0; i < count; ++i)
+		depths[i] = static_cast<uint16_t>(src[i].R * 257);
+}
+
+static const FormatInfo& GetFormatInfo(Sqex::Texture::Format format) {
+	using Sqex::Texture::Format;
+	static const FormatInfo Infos[]{
+		{Format::L8, 1, L8ToRGBA8888, L8FromRGBA8888},
+		{Format::A8, 1, L8ToRGBA8888, L8FromRGBA8888},
+		{Format::A4R4G4B4, 2, RGBA4444ToRGBA8888, RGBA4444FromRGBA8888},
+		{Format::A1R5G5B5, 2, RGBA5551ToRGBA8888, RGBA5551FromRGBA8888},
+		{Format::A8R8G8B8, 4, RGBA8888ToRGBA8888, RGBA8888FromRGBA8888},
+		{Format::X8R8G8B8, 4, RGBA8888ToRGBA8888, RGBA8888FromRGBA8888},
+		{Format::R32F, 4, R32FToRGBA8888, R32FFromRGBA8888},
+		{Format::G16R16F, 4, G16R16FToRGBA8888, G16R16FFromRGBA8888},
+		{Format::G32R32F, 8, G32R32FToRGBA8888, G32R32FFromRGBA8888},
+		{Format::A16B16G16R16F, 8, RGBAHHHHToRGBA8888, RGBAHHHHFromRGBA8888},
+		{Format::A32B32G32R32F, 16, RGBAFFFFToRGBA8888, RGBAFFFFFromRGBA8888},
+		{Format::D16, 2, D16ToRGBA8888, D16FromRGBA8888},
+	};
+	for (const auto& info : Infos) {
+		if (info.Type == format)
+			return info;
+	}
+	throw std::invalid_argument("Unsupported type");
+}
+
+size_t Sqex::Texture::BytesPerPixel(Format format) {
+	switch (format) {
+		case Format::DXT1:
+		case Format::DXT3:
+		case Format::DXT5:
+		case Format::BC4:
+		case Format::BC5:
+		case Format::BC7:
+		case Format::Unknown:
+			return 0;
+		default:
+			return GetFormatInfo(format).BytesPerPixel;
+	}
+}
+
+void Sqex::Texture::ConvertToRGBA8888(Format format, std::span<const uint8_t> source, std::span<RGBA8888> target) {
+	const auto& info = GetFormatInfo(format);
+	if (source.size() < target.size() * info.BytesPerPixel)
+		throw std::invalid_argument("source is smaller than target");
+	info.ToRGBA8888(source.data(), target.data(), target.size());
+}
+
+void Sqex::Texture::ConvertFromRGBA8888(Format format, std::span<const RGBA8888> source, std::span<uint8_t> target) {
+	const auto& info = GetFormatInfo(format);
+	if (target.size() < source.size() * info.BytesPerPixel)
+		throw std::invalid_argument("target is smaller than source");
+	info.FromRGBA8888(source.data(), target.data(), source.size());
+}
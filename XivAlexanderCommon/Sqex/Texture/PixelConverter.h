@@ -0,0 +1,16 @@
+#pragma once
+
+#include "XivAlexanderCommon/Sqex/Texture.h"
+
+namespace Sqex::Texture {
+	// Number of bytes a pixel of an uncompressed format takes, or 0 for block compressed and unknown formats.
+	size_t BytesPerPixel(Format format);
+
+	// Converts every pixel in source, which is of the given uncompressed format, into target.
+	// Channels the source format does not have become 0, except for opacity, which becomes 255.
+	// L8 and A8 are spread over the three colour channels.
+	void ConvertToRGBA8888(Format format, std::span<const uint8_t> source, std::span<RGBA8888> target);
+
+	// Inverse of ConvertToRGBA8888. Channels the target format cannot hold are dropped; L8, A8 and D16 take the R channel.
+	void ConvertFromRGBA8888(Format format, std::span<const RGBA8888> source, std::span<uint8_t> target);
+}
@@ -1,6 +1,8 @@
 #include "pch.h"
 #include "XivAlexanderCommon/Utils/Win32/ThreadPool.h"
 
+#include <atomic>
+
 static DWORD GetNumberOfProcessors() {
 	SYSTEM_INFO sysInfo;
 	GetNativeSystemInfo(&sysInfo);
@@ -93,3 +95,49 @@ void Utils::Win32::TpEnvironment::Cancel() {
 
 	m_cancelling = false;
 }
+
+void Utils::Win32::ParallelFor(size_t count, const std::function<void(size_t)>& fn, size_t maxParallelism) {
+	struct State {
+		const std::function<void(size_t)>& Fn;
+		const size_t Count;
+		std::atomic<size_t> Next = 0;
+		std::mutex ErrorMtx;
+		std::exception_ptr Error;
+
+		void Run() {
+			for (size_t i; (i = Next++) < Count;) {
+				try {
+					Fn(i);
+				} catch (...) {
+					const auto lock = std::lock_guard(ErrorMtx);
+					if (!Error)
+						Error = std::current_exception();
+					Next = Count;
+				}
+			}
+		}
+	} state{ fn, count };
+
+	const auto parallelism = std::min<size_t>({ count, maxParallelism, GetNumberOfProcessors() });
+	PTP_WORK work = nullptr;
+	if (parallelism > 1) {
+		work = CreateThreadpoolWork([](PTP_CALLBACK_INSTANCE, void* ctx, PTP_WORK) {
+			static_cast<State*>(ctx)->Run();
+		}, &state, nullptr);
+		if (work) {
+			for (size_t i = 1; i < parallelism; ++i)
+				SubmitThreadpoolWork(work);
+		}
+	}
+
+	state.Run();
+
+	if (work) {
+		// Callbacks that have not started yet would find nothing to do; cancel them, and wait for the rest.
+		WaitForThreadpoolWorkCallbacks(work, TRUE);
+		CloseThreadpoolWork(work);
+	}
+
+	if (state.Error)
+		std::rethrow_exception(state.Error);
+}
@@ -27,4 +27,8 @@ namespace Utils::Win32 {
 		void WaitOutstanding();
 		void Cancel();
 	};
+
+	// Calls fn(i) for every i in [0, count) on the calling thread and the process default thread pool, and returns once every call is done.
+	// The first exception thrown stops handing out further indices, and is rethrown after the calls in progress finish.
+	void ParallelFor(size_t count, const std::function<void(size_t)>& fn, size_t maxParallelism = SIZE_MAX);
 }
\ No newline at end of file